@@ -0,0 +1,49 @@
+#   Collisions - a real-time simulation program of colliding particles.
+#   Copyright (C) 2011 - 2015  G. Endignoux
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+
+
+
+
+# Mesures de performance de la simulation (voir README.md), à lancer avec -platform offscreen.
+TEMPLATE = app
+TARGET = bench
+CONFIG += console
+CONFIG -= app_bundle
+SRC = ../src
+INCLUDEPATH += . $$SRC $$SRC/config $$SRC/edit $$SRC/graphic $$SRC/math $$SRC/simul
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
+
+# Toutes les sources du programme, sauf son point d'entrée et le délégué inutilisé de edit/.
+HEADERS += \
+    $$files($$SRC/*.hpp, true) \
+    trace.hpp
+HEADERS -= \
+    $$SRC/edit/_coord_delegate.hpp
+
+SOURCES += \
+    $$files($$SRC/*.cpp, true) \
+    main.cpp \
+    trace.cpp
+SOURCES -= \
+    $$SRC/edit/_coord_delegate.cpp \
+    $$SRC/main.cpp
+
+RESOURCES += \
+    $$SRC/collisions.qrc
+
+greaterThan(QT_MAJOR_VERSION, 4): CONFIG += c++14
+QMAKE_CXXFLAGS += --std=c++14
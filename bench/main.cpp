@@ -0,0 +1,403 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include <QApplication>
+#include <QFile>
+#include <QDataStream>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include "simulateur.hpp"
+#include "solveur.hpp"
+#include "trace.hpp"
+
+// Mesures de performance de la simulation, hors de l'interface graphique (voir README.md).
+// Les simulations démarrent toujours avec la même graine, pour que les nombres de chocs soient comparables.
+
+// Options des simulations.
+struct Options
+{
+    int mImages = 20;
+    int mVitesse = 0;
+    bool mCalendar = false;
+    bool mVoisins = false;
+    QStringList mFichiers;
+};
+
+// Durée écoulée depuis un instant (en millisecondes).
+static double duree(std::chrono::steady_clock::time_point debut)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - debut).count();
+}
+
+// Charge la configuration d'un fichier de simulation.
+static bool charge(const QString& path, Configuration& config)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    quint32 magic;
+    stream >> magic;
+    if (magic != 0xC0117870)
+        return false;
+
+    stream >> config;
+    return stream.status() == QDataStream::Ok;
+}
+
+// Simule un fichier pendant le nombre d'images demandé et affiche les compteurs.
+static bool simule(const QString& path, const Options& options)
+{
+    Configuration config;
+    if (!charge(path, config))
+    {
+        std::cerr << "Unable to load file '" << path.toStdString() << "'" << std::endl;
+        return false;
+    }
+
+    Simulateur simulateur(config);
+    simulateur.state().generateur.seed(42);
+
+    // Les réglages sont des slots privés : ils sont appelés comme depuis l'interface.
+    QMetaObject::invokeMethod(&simulateur, "setVitesse", Qt::DirectConnection, Q_ARG(int, options.mVitesse));
+    QMetaObject::invokeMethod(&simulateur, "setValues", Qt::DirectConnection, Q_ARG(int, 0));
+    QMetaObject::invokeMethod(&simulateur, "setCourbes", Qt::DirectConnection, Q_ARG(int, -250));
+    QMetaObject::invokeMethod(&simulateur, "setScheduler", Qt::DirectConnection, Q_ARG(int, options.mCalendar ? Scheduler::_calendar : Scheduler::_heap));
+    QMetaObject::invokeMethod(&simulateur, "setRecherche", Qt::DirectConnection, Q_ARG(int, options.mVoisins ? State::_voisins : State::_cases));
+
+    auto debut = std::chrono::steady_clock::now();
+    simulateur.doRestart();
+    double create = duree(debut);
+
+    debut = std::chrono::steady_clock::now();
+    for (int i = 0 ; i < options.mImages ; ++i)
+    {
+        while (!simulateur.playSlice(40));
+        simulateur.refreshView();
+    }
+    double run = duree(debut);
+
+    const State& state = simulateur.state();
+    std::cout << path.toStdString() << ": N=" << state.boules.size()
+              << " create=" << create << "ms run=" << run << "ms"
+              << " chocs=" << state.countChocs << " chocs/s=" << int(1000 * state.countChocs / run)
+              << " rasantes=" << state.countDegeneres.rasantes << " repetees=" << state.countDegeneres.repetees
+              << std::endl;
+    return true;
+}
+
+// Enregistre les opérations reçues par l'ordonnanceur pendant une simulation, puis les rejoue sur chaque ordonnanceur.
+static bool rejoue(const Options& options)
+{
+    Trace trace;
+    trace.debut();
+    bool ok = simule(options.mFichiers.front(), options);
+    trace.fin();
+    if (!ok)
+        return false;
+
+    std::cout << "trace: " << trace.size() << " operations" << std::endl;
+    for (Scheduler::Type type : {Scheduler::_heap, Scheduler::_calendar})
+    {
+        // Meilleur temps sur 3 passes.
+        double meilleur = std::numeric_limits<double>::infinity();
+        for (unsigned int i = 0 ; i < 3 ; ++i)
+            meilleur = std::min(meilleur, trace.rejoue(type));
+
+        std::cout << (type == Scheduler::_heap ? "heap" : "calendar") << ": " << meilleur << "ms"
+                  << " ecarts=" << trace.verifie(type) << std::endl;
+    }
+    return true;
+}
+
+// Compare Solveur::fstContact (contact avec un sommet sous gravité) à Solveur::fstQuartique :
+// précision par rapport à une recherche exhaustive du premier contact, puis durée par appel.
+static void contact()
+{
+    // Position relative, vitesse, gravité et rayon : f(t) = |p + v t + g t^2 / 2|^2 - r^2.
+    struct Cas
+    {
+        double px, py, vx, vy, gx, gy, r;
+
+        double f(double t) const
+        {
+            double x = px + vx * t + gx * t * t / 2;
+            double y = py + vy * t + gy * t * t / 2;
+            return x * x + y * y - r * r;
+        }
+    };
+
+    std::mt19937 generateur(3);
+    std::uniform_real_distribution<> distrib(-1, 1);
+    std::vector<Cas> cas;
+    while (cas.size() < 200000)
+    {
+        Cas c{distrib(generateur) * 20, distrib(generateur) * 20, distrib(generateur) * 10, distrib(generateur) * 10,
+              0, 10 * (1 + distrib(generateur)), 2};
+        if (c.px * c.px + c.py * c.py >= c.r * c.r)
+            cas.push_back(c);
+    }
+
+    // Coefficients de la quartique (a, b, c, d, e).
+    auto coefficients = [](const Cas& c) {
+        double g2 = c.gx * c.gx + c.gy * c.gy;
+        double gv = c.gx * c.vx + c.gy * c.vy;
+        double gp = c.gx * c.px + c.gy * c.py;
+        double v2 = c.vx * c.vx + c.vy * c.vy;
+        double vp = c.vx * c.px + c.vy * c.py;
+        double p2 = c.px * c.px + c.py * c.py;
+        return std::array<double, 5>{{g2 / 4, gv, v2 + gp, 2 * vp, p2 - c.r * c.r}};
+    };
+    const double infini = std::numeric_limits<double>::infinity();
+
+    // Précision : premier contact cherché par pas de 1e-4 sur [0, 20], puis par dichotomie.
+    unsigned int trouves = 0, ecartsContact = 0, ecartsQuartique = 0;
+    for (unsigned int i = 0 ; i < 20000 ; ++i)
+    {
+        const Cas& c = cas[i];
+        double reference = -1;
+        double precedent = c.f(0);
+        for (unsigned int k = 1 ; k <= 200000 ; ++k)
+        {
+            double t = k * 1e-4;
+            double valeur = c.f(t);
+            if (precedent > 0 && valeur <= 0)
+            {
+                double min = t - 1e-4, max = t;
+                for (unsigned int j = 0 ; j < 80 ; ++j)
+                {
+                    double milieu = (min + max) / 2;
+                    if (c.f(milieu) > 0)
+                        min = milieu;
+                    else
+                        max = milieu;
+                }
+                reference = max;
+                break;
+            }
+            precedent = valeur;
+        }
+
+        auto ecart = [reference](double t) {
+            return (reference < 0) != (t < 0) || (reference >= 0 && std::abs(t - reference) > 1e-6 * (1 + reference));
+        };
+
+        auto k = coefficients(c);
+        if (reference >= 0)
+            ++trouves;
+        if (ecart(Solveur::fstContact(k[0], k[1], k[2], k[3], k[4], infini)))
+            ++ecartsContact;
+        if (ecart(Solveur::fstQuartique(k[0], k[1], k[2], k[3], k[4])))
+            ++ecartsQuartique;
+    }
+    std::cout << "contacts=" << trouves << " ecarts: fstContact=" << ecartsContact
+              << " fstQuartique=" << ecartsQuartique << std::endl;
+
+    // Trajectoires rasantes : le rayon dépasse d'un facteur 1 + 1e-14 la distance minimale, atteinte entre 0.01 et 5.
+    // Un contact existe donc toujours ; il est manqué (pas de racine) ou faux (la quartique n'y est pas nulle).
+    generateur.seed(5);
+    unsigned int rasants = 0;
+    std::array<unsigned int, 2> manques{{0, 0}}, faux{{0, 0}};
+    for (unsigned int i = 0 ; i < 20000 ; ++i)
+    {
+        Cas c{distrib(generateur) * 20, distrib(generateur) * 20, distrib(generateur) * 10, distrib(generateur) * 10,
+              0, 10, 0};
+
+        // Instant de la distance minimale, par pas de 1e-4 puis par trichotomie.
+        double tMin = 0;
+        for (unsigned int k = 1 ; k <= 50000 ; ++k)
+            if (c.f(k * 1e-4) < c.f(tMin))
+                tMin = k * 1e-4;
+        if (tMin <= 0.01 || tMin >= 4.99)
+            continue;
+
+        double min = tMin - 1e-4, max = tMin + 1e-4;
+        for (unsigned int j = 0 ; j < 200 ; ++j)
+        {
+            double t1 = min + (max - min) / 3, t2 = max - (max - min) / 3;
+            if (c.f(t1) < c.f(t2))
+                max = t2;
+            else
+                min = t1;
+        }
+        c.r = std::sqrt(c.f((min + max) / 2)) * (1 + 1e-14);
+        ++rasants;
+
+        auto k = coefficients(c);
+        std::array<double, 2> racines{{Solveur::fstContact(k[0], k[1], k[2], k[3], k[4], infini),
+                                       Solveur::fstQuartique(k[0], k[1], k[2], k[3], k[4])}};
+        for (unsigned int j = 0 ; j < 2 ; ++j)
+        {
+            if (racines[j] < 0)
+                ++manques[j];
+            else if (std::abs(c.f(racines[j])) > 1e-6 * c.r * c.r)
+                ++faux[j];
+        }
+    }
+    std::cout << "rasants=" << rasants << " manques/faux: fstContact=" << manques[0] << "/" << faux[0]
+              << " fstQuartique=" << manques[1] << "/" << faux[1] << std::endl;
+
+    // Durée par appel (la somme des racines empêche de supprimer les appels à la compilation).
+    double somme = 0;
+    auto debut = std::chrono::steady_clock::now();
+    for (auto& c : cas)
+    {
+        auto k = coefficients(c);
+        somme += Solveur::fstQuartique(k[0], k[1], k[2], k[3], k[4]);
+    }
+    double quartique = duree(debut);
+
+    debut = std::chrono::steady_clock::now();
+    for (auto& c : cas)
+    {
+        auto k = coefficients(c);
+        somme += Solveur::fstContact(k[0], k[1], k[2], k[3], k[4], infini);
+    }
+    double nouveau = duree(debut);
+
+    std::cout << "fstQuartique=" << 1e6 * quartique / cas.size() << "ns fstContact=" << 1e6 * nouveau / cas.size()
+              << "ns (somme " << somme << ")" << std::endl;
+}
+
+// Mobile réduit aux données du changement de vitesse lors d'un choc.
+struct Disque
+{
+    Coord<double> mPosition;
+    Coord<double> mVitesse;
+    double mMasse;
+};
+
+// Changement des vitesses lors d'un choc entre deux boules, comme dans Boule::doCollision.
+static void __attribute__((noinline)) choc(Disque& disque1, Disque& disque2)
+{
+    Coord<double> dPosition = disque2.mPosition - disque1.mPosition;
+    Coord<double> dVitesse = disque2.mVitesse - disque1.mVitesse;
+
+    if (dPosition.scalar(dVitesse) < 0.0)
+    {
+        dPosition /= dPosition.length();
+
+        Coord<double> vitesse1 = Coord<double>(disque1.mVitesse.scalar(dPosition), dPosition.det(disque1.mVitesse));
+        Coord<double> vitesse2 = Coord<double>(disque2.mVitesse.scalar(dPosition), dPosition.det(disque2.mVitesse));
+
+        double masse1 = disque1.mMasse, masse2 = disque2.mMasse;
+        disque1.mVitesse = (dPosition * (vitesse1.x * (masse1 - masse2) + vitesse2.x * 2.0 * masse2) / (masse1 + masse2)
+                     + Coord<double>(-dPosition.y, dPosition.x) * vitesse1.y);
+        disque2.mVitesse = (dPosition * (vitesse2.x * (masse2 - masse1) + vitesse1.x * 2.0 * masse1) / (masse1 + masse2)
+                     + Coord<double>(-dPosition.y, dPosition.x) * vitesse2.y);
+    }
+}
+
+// Durée du changement des vitesses sur 512 paires de boules (meilleure de 7 séries de 2000 passes).
+static void chocs()
+{
+    std::mt19937 generateur(1);
+    std::uniform_real_distribution<> distrib(-1, 1);
+    std::vector<Disque> disques(1024);
+    for (auto& disque : disques)
+        disque = Disque{Coord<double>(distrib(generateur), distrib(generateur)),
+                        Coord<double>(distrib(generateur), distrib(generateur)),
+                        1 + distrib(generateur) * 0.5};
+
+    double meilleur = std::numeric_limits<double>::infinity();
+    for (unsigned int serie = 0 ; serie < 7 ; ++serie)
+    {
+        double total = 0;
+        for (unsigned int passe = 0 ; passe < 2000 ; ++passe)
+        {
+            // Vitesses réinitialisées à chaque passe (hors mesure).
+            for (unsigned int i = 0 ; i < disques.size() ; ++i)
+                disques[i].mVitesse = Coord<double>(double((i * 7919) % 97) / 50 - 1, double((i * 104729) % 89) / 45 - 1);
+
+            auto debut = std::chrono::steady_clock::now();
+            for (unsigned int i = 0 ; i + 1 < disques.size() ; i += 2)
+                choc(disques[i], disques[i + 1]);
+            total += duree(debut);
+        }
+        meilleur = std::min(meilleur, 1e6 * total / (2000 * disques.size() / 2));
+    }
+
+    // La somme des vitesses finales permet de vérifier que les résultats sont identiques au bit près.
+    double somme = 0;
+    for (auto& disque : disques)
+        somme += disque.mVitesse.x + disque.mVitesse.y;
+    std::cout.precision(17);
+    std::cout << meilleur << "ns/choc (somme " << somme << ")" << std::endl;
+}
+
+// Lit les options des modes samples et replay.
+static bool options(const QStringList& arguments, Options& options)
+{
+    for (int i = 2 ; i < arguments.size() ; ++i)
+    {
+        const QString& argument = arguments[i];
+        if (argument == "--frames" && i + 1 < arguments.size())
+            options.mImages = arguments[++i].toInt();
+        else if (argument == "--vitesse" && i + 1 < arguments.size())
+            options.mVitesse = arguments[++i].toInt();
+        else if (argument == "--calendar")
+            options.mCalendar = true;
+        else if (argument == "--voisins")
+            options.mVoisins = true;
+        else if (argument.startsWith("--"))
+            return false;
+        else
+            options.mFichiers.append(argument);
+    }
+    return !options.mFichiers.isEmpty();
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    QStringList arguments = app.arguments();
+    QString mode = arguments.size() > 1 ? arguments[1] : QString();
+
+    Options opts;
+    if (mode == "samples" && options(arguments, opts))
+    {
+        bool ok = true;
+        for (auto& fichier : opts.mFichiers)
+            ok = simule(fichier, opts) && ok;
+        return ok ? 0 : 1;
+    }
+    if (mode == "replay" && options(arguments, opts) && opts.mFichiers.size() == 1 && !opts.mCalendar)
+        return rejoue(opts) ? 0 : 1;
+    if (mode == "contact")
+    {
+        contact();
+        return 0;
+    }
+    if (mode == "choc")
+    {
+        chocs();
+        return 0;
+    }
+
+    std::cerr << "Usage:" << std::endl
+              << "  bench samples [--frames N] [--vitesse V] [--calendar] [--voisins] file.col..." << std::endl
+              << "  bench replay [--frames N] [--vitesse V] [--voisins] file.col" << std::endl
+              << "  bench contact" << std::endl
+              << "  bench choc" << std::endl;
+    return 1;
+}
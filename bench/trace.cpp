@@ -0,0 +1,192 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "trace.hpp"
+
+#include <chrono>
+
+// Trace en cours d'enregistrement.
+Trace* Trace::enregistrement = nullptr;
+
+// Commence l'enregistrement.
+void Trace::debut()
+{
+    enregistrement = this;
+    Scheduler::enveloppe = &Trace::enveloppe;
+}
+
+// Arrête l'enregistrement.
+void Trace::fin()
+{
+    enregistrement = nullptr;
+    Scheduler::enveloppe = nullptr;
+}
+
+// Ajoute un ajout en bloc.
+void Trace::addAll(const std::vector<std::pair<Scheduler::Handle, Time> >& events)
+{
+    this->add(Operation::_pushAll, mLots.size());
+    mLots.push_back(events);
+}
+
+// Enveloppe un ordonnanceur créé pendant l'enregistrement.
+std::unique_ptr<Scheduler> Trace::enveloppe(std::unique_ptr<Scheduler> scheduler)
+{
+    enregistrement->add(Operation::_create);
+    return std::make_unique<TraceScheduler>(std::move(scheduler), *enregistrement);
+}
+
+// Rejoue la trace sur un ordonnanceur du type indiqué et renvoie la durée.
+double Trace::rejoue(Scheduler::Type type) const
+{
+    std::unique_ptr<Scheduler> scheduler;
+    Scheduler::Handle somme = 0;
+
+    auto debut = std::chrono::steady_clock::now();
+    for (auto& operation : mOperations)
+        somme += this->execute(operation, type, scheduler);
+    auto fin = std::chrono::steady_clock::now();
+
+    // Le résultat des appels à top() est utilisé, pour qu'ils ne soient pas supprimés à la compilation.
+    static volatile Scheduler::Handle puits;
+    puits = somme;
+    return std::chrono::duration<double, std::milli>(fin - debut).count();
+}
+
+// Rejoue la trace en vérifiant les dates des événements en tête.
+unsigned int Trace::verifie(Scheduler::Type type) const
+{
+    std::unique_ptr<Scheduler> scheduler;
+    std::vector<Time> times;
+    auto setTime = [&](Scheduler::Handle handle, const Time& time) {
+        if (handle >= times.size())
+            times.resize(handle + 1);
+        times[handle] = time;
+    };
+
+    unsigned int ecarts = 0;
+    for (auto& operation : mOperations)
+    {
+        if (operation.mType == Operation::_push || operation.mType == Operation::_update)
+            setTime(operation.mHandle, operation.mTime);
+        else if (operation.mType == Operation::_pushAll)
+            for (auto& event : mLots[operation.mHandle])
+                setTime(event.first, event.second);
+
+        Scheduler::Handle handle = this->execute(operation, type, scheduler);
+        if (operation.mType == Operation::_top && times[handle] != operation.mTime)
+            ++ecarts;
+    }
+
+    return ecarts;
+}
+
+// Effectue une opération (renvoie l'événement en tête pour _top, 0 sinon).
+inline Scheduler::Handle Trace::execute(const Operation& operation, Scheduler::Type type, std::unique_ptr<Scheduler>& scheduler) const
+{
+    switch (operation.mType)
+    {
+    case Operation::_create:
+        scheduler = Scheduler::create(type);
+        break;
+    case Operation::_clear:
+        scheduler->clear();
+        break;
+    case Operation::_push:
+        scheduler->push(operation.mHandle, operation.mTime);
+        break;
+    case Operation::_pushAll:
+        scheduler->pushAll(mLots[operation.mHandle]);
+        break;
+    case Operation::_update:
+        scheduler->update(operation.mHandle, operation.mTime);
+        break;
+    case Operation::_remove:
+        scheduler->remove(operation.mHandle);
+        break;
+    case Operation::_top:
+        return scheduler->top();
+    }
+    return 0;
+}
+
+
+// Constructeur.
+TraceScheduler::TraceScheduler(std::unique_ptr<Scheduler> scheduler, Trace& trace) :
+    mScheduler(std::move(scheduler)),
+    mTrace(trace),
+    mTimes()
+{
+}
+
+void TraceScheduler::clear()
+{
+    mTrace.add(Trace::Operation::_clear);
+    mScheduler->clear();
+}
+
+void TraceScheduler::push(Handle handle, const Time& time)
+{
+    mTrace.add(Trace::Operation::_push, handle, time);
+    if (handle >= mTimes.size())
+        mTimes.resize(handle + 1);
+    mTimes[handle] = time;
+    mScheduler->push(handle, time);
+}
+
+void TraceScheduler::pushAll(const std::vector<std::pair<Handle, Time> >& events)
+{
+    mTrace.addAll(events);
+    for (auto& event : events)
+    {
+        if (event.first >= mTimes.size())
+            mTimes.resize(event.first + 1);
+        mTimes[event.first] = event.second;
+    }
+    mScheduler->pushAll(events);
+}
+
+void TraceScheduler::update(Handle handle, const Time& time)
+{
+    mTrace.add(Trace::Operation::_update, handle, time);
+    mTimes[handle] = time;
+    mScheduler->update(handle, time);
+}
+
+void TraceScheduler::remove(Handle handle)
+{
+    mTrace.add(Trace::Operation::_remove, handle);
+    mScheduler->remove(handle);
+}
+
+bool TraceScheduler::contains(Handle handle) const
+{
+    return mScheduler->contains(handle);
+}
+
+unsigned int TraceScheduler::size() const
+{
+    return mScheduler->size();
+}
+
+TraceScheduler::Handle TraceScheduler::top()
+{
+    Handle handle = mScheduler->top();
+    mTrace.add(Trace::Operation::_top, handle, mTimes[handle]);
+    return handle;
+}
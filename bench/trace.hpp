@@ -0,0 +1,109 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <memory>
+#include <vector>
+#include "scheduler.hpp"
+
+// Trace des opérations reçues par les ordonnanceurs d'une simulation, pour les rejouer sur chaque ordonnanceur.
+// Pendant l'enregistrement, Scheduler::create enveloppe chaque ordonnanceur créé dans un TraceScheduler.
+class Trace
+{
+public:
+    // Opération reçue par un ordonnanceur (la création d'un ordonnanceur remplace le précédent).
+    struct Operation
+    {
+        enum Type
+        {
+            _create, _clear, _push, _pushAll, _update, _remove, _top
+        };
+
+        Type mType;
+        // Evénement concerné (pour _pushAll : indice du lot, pour _top : événement renvoyé).
+        Scheduler::Handle mHandle;
+        Time mTime;
+    };
+
+    // Commence et arrête l'enregistrement des opérations des ordonnanceurs créés entre-temps.
+    void debut();
+    void fin();
+    // Ajoute une opération.
+    inline void add(Operation::Type type, Scheduler::Handle handle = 0, const Time& time = Time());
+    // Ajoute un ajout en bloc.
+    void addAll(const std::vector<std::pair<Scheduler::Handle, Time> >& events);
+
+    // Rejoue la trace sur un ordonnanceur du type indiqué et renvoie la durée (en millisecondes).
+    double rejoue(Scheduler::Type type) const;
+    // Rejoue la trace en vérifiant que chaque événement en tête a la même date que lors de l'enregistrement
+    // (renvoie le nombre de dates différentes).
+    unsigned int verifie(Scheduler::Type type) const;
+
+    // Accesseurs.
+    inline unsigned int size() const;
+
+private:
+    // Enveloppe un ordonnanceur créé pendant l'enregistrement (voir Scheduler::enveloppe).
+    static std::unique_ptr<Scheduler> enveloppe(std::unique_ptr<Scheduler> scheduler);
+    // Effectue une opération sur l'ordonnanceur, créé par _create (renvoie l'événement en tête pour _top, 0 sinon).
+    inline Scheduler::Handle execute(const Operation& operation, Scheduler::Type type, std::unique_ptr<Scheduler>& scheduler) const;
+
+    // Trace en cours d'enregistrement (nullptr si aucune).
+    static Trace* enregistrement;
+
+    // Opérations, et événements des ajouts en bloc.
+    std::vector<Operation> mOperations;
+    std::vector<std::vector<std::pair<Scheduler::Handle, Time> > > mLots;
+};
+
+// Ordonnanceur enregistrant les opérations reçues avant de les transmettre à l'ordonnanceur enveloppé.
+class TraceScheduler : public Scheduler
+{
+public:
+    // Constructeur.
+    TraceScheduler(std::unique_ptr<Scheduler> scheduler, Trace& trace);
+
+    void clear();
+
+    void push(Handle handle, const Time& time);
+    void pushAll(const std::vector<std::pair<Handle, Time> >& events);
+    void update(Handle handle, const Time& time);
+    void remove(Handle handle);
+
+    bool contains(Handle handle) const;
+    unsigned int size() const;
+    Handle top();
+
+private:
+    std::unique_ptr<Scheduler> mScheduler;
+    Trace& mTrace;
+    // Dates des événements (pour enregistrer celle de l'événement en tête).
+    std::vector<Time> mTimes;
+};
+
+// Ajoute une opération.
+inline void Trace::add(Operation::Type type, Scheduler::Handle handle, const Time& time)
+    {mOperations.push_back(Operation{type, handle, time});}
+
+// Accesseurs.
+inline unsigned int Trace::size() const
+    {return mOperations.size();}
+
+#endif // TRACE_HPP
@@ -18,7 +18,7 @@
 TEMPLATE = app
 INCLUDEPATH += . config/ edit/ graphic/ math/ simul/
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
 
 # Input
 HEADERS += \
@@ -60,16 +60,25 @@ HEADERS += \
     math/coord_io.tpl \
     math/coord_qio.tpl \
     math/polygone.hpp \
+    math/quadratiques.hpp \
     math/segment.hpp \
     math/solveur.hpp \
     simul/boule.hpp \
+    simul/calendar_scheduler.hpp \
     simul/collision.hpp \
     simul/event.hpp \
-    simul/map_ligne.hpp \
+    simul/event_queue.hpp \
+    simul/gravite.hpp \
+    simul/grille.hpp \
+    simul/heap_scheduler.hpp \
+    simul/instantane.hpp \
     simul/mobile.hpp \
     simul/obstacle.hpp \
+    simul/paires.hpp \
+    simul/particules.hpp \
     simul/piston.hpp \
     simul/population.hpp \
+    simul/scheduler.hpp \
     simul/simulateur.hpp \
     simul/state.hpp \
     simul/time.hpp
@@ -110,14 +119,22 @@ SOURCES += \
     main.cpp \
     main_window.cpp \
     math/polygone.cpp \
+    math/quadratiques.cpp \
     math/segment.cpp \
     math/solveur.cpp \
     simul/boule.cpp \
+    simul/calendar_scheduler.cpp \
     simul/collision.cpp \
     simul/event.cpp \
+    simul/event_queue.cpp \
+    simul/grille.cpp \
+    simul/heap_scheduler.cpp \
+    simul/instantane.cpp \
     simul/mobile.cpp \
+    simul/particules.cpp \
     simul/piston.cpp \
     simul/population.cpp \
+    simul/scheduler.cpp \
     simul/simulateur.cpp \
     simul/state.cpp \
     simul/time.cpp
@@ -44,23 +44,25 @@ void ConfigCible::addValue(unsigned int valType, const Polygone& polygone, State
         return;
 
     // Parcourt la population choisie.
-    for (auto& ptr : state.boules)
+    const Particules& particules = state.particules;
+    for (unsigned int i = 0 ; i < particules.size() ; ++i)
     {
-        const Boule& boule = *ptr;
-        if (boule.population() == mIndex)
+        if (particules.population[i] == mIndex)
         {
             // Mesure seulement les boules dans la zone choisie.
-            if (mPolygone.inside(boule.position()) && polygone.inside(boule.position()))
+            Coord<double> position(particules.x[i], particules.y[i]);
+            if (mPolygone.inside(position) && polygone.inside(position))
             {
-                if (values.contains(std::floor(boule.position().y / slice)))
+                int tranche = std::floor(position.y / slice);
+                if (values.contains(tranche))
                 {
-                    values[std::floor(boule.position().y / slice)] += this->profilValue(valType, boule);
-                    ++nbres[std::floor(boule.position().y / slice)];
+                    values[tranche] += this->profilValue(valType, particules, i);
+                    ++nbres[tranche];
                 }
                 else
                 {
-                    values[std::floor(boule.position().y / slice)] = this->profilValue(valType, boule);
-                    nbres[std::floor(boule.position().y / slice)] = 1;
+                    values[tranche] = this->profilValue(valType, particules, i);
+                    nbres[tranche] = 1;
                 }
             }
         }
@@ -120,15 +122,16 @@ double ConfigCible::valuePopulation(unsigned int valType, State& state, const Po
     double valeur = 0;
 
     // Parcourt la population.
-    for (auto& ptr : state.boules)
+    const Particules& particules = state.particules;
+    for (unsigned int i = 0 ; i < particules.size() ; ++i)
     {
-        const Boule& boule = *ptr;
-        if (boule.population() == mIndex)
+        if (particules.population[i] == mIndex)
         {
             // Mesure seulement les boules dans la zone choisie.
-            if (mPolygone.inside(boule.position()) && polygone.inside(boule.position()))
+            Coord<double> position(particules.x[i], particules.y[i]);
+            if (mPolygone.inside(position) && polygone.inside(position))
             {
-                valeur += this->value(valType, boule);
+                valeur += this->value(valType, state, i);
                 ++nbre;
             }
         }
@@ -137,42 +140,47 @@ double ConfigCible::valuePopulation(unsigned int valType, State& state, const Po
     return valeur;
 }
 
-// Mesure une valeur (de type courbe) sur une boule.
-double ConfigCible::value(unsigned int valType, const Boule& boule)
+// Mesure une valeur (de type courbe) sur une boule (indiquée par son rang).
+// Les grandeurs cinématiques sont lues dans les tableaux des particules, les autres sur la boule elle-même.
+double ConfigCible::value(unsigned int valType, const State& state, unsigned int rang)
 {
+    const Particules& particules = state.particules;
+    Coord<double> position(particules.x[rang], particules.y[rang]);
+    Coord<double> vitesse(particules.vx[rang], particules.vy[rang]);
+
     if (valType == ConfigWidgetCourbe::posX)
-        return boule.position().x;
+        return position.x;
     if (valType == ConfigWidgetCourbe::posY)
-        return -boule.position().y;
+        return -position.y;
     if (valType == ConfigWidgetCourbe::vitX)
-        return boule.vitesse().x;
+        return vitesse.x;
     if (valType == ConfigWidgetCourbe::vitY)
-        return -boule.vitesse().y;
+        return -vitesse.y;
     if (valType == ConfigWidgetCourbe::vit)
-        return boule.vitesse().length();
+        return vitesse.length();
     if (valType == ConfigWidgetCourbe::vit2)
-        return boule.vitesse().squareLength();
+        return vitesse.squareLength();
     if (valType == ConfigWidgetCourbe::energy)
-        return boule.masse() * boule.vitesse().squareLength();
+        return particules.masse[rang] * vitesse.squareLength();
     if (valType == ConfigWidgetCourbe::freeRide)
-        return boule.freeRide().length();
+        return state.boules[rang]->freeRide().length();
     if (valType == ConfigWidgetCourbe::freeTime)
-        return boule.freeTime().time();
+        return state.boules[rang]->freeTime().time();
     if (valType == ConfigWidgetCourbe::fromOrigin)
-        return boule.fromOrigin().length();
+        return (position - state.boules[rang]->origine()).length();
     if (valType == ConfigWidgetCourbe::fromOrigin2)
-        return boule.fromOrigin().squareLength();
+        return (position - state.boules[rang]->origine()).squareLength();
     if (valType == ConfigWidgetCourbe::count)
         return 1;
 
     return std::numeric_limits<double>::quiet_NaN();
 }
 
-// Mesure une valeur (de type profil) sur une boule.
-double ConfigCible::profilValue(unsigned int valType, const Boule& boule)
+// Mesure une valeur (de type profil) sur une boule (indiquée par son rang).
+double ConfigCible::profilValue(unsigned int valType, const Particules& particules, unsigned int rang)
 {
     if (valType == ConfigProfil::energy)
-        return boule.masse() * boule.vitesse().squareLength();
+        return particules.masse[rang] * (particules.vx[rang] * particules.vx[rang] + particules.vy[rang] * particules.vy[rang]);
     if (valType == ConfigProfil::count)
         return 1;
 
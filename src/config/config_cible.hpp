@@ -26,7 +26,7 @@
 class State;
 class Population;
 class Piston;
-class Boule;
+class Particules;
 
 // Configuration d'une cible.
 // Les cibles représentent un ensemble de mobiles pour lesquels tracer une courbe.
@@ -55,8 +55,8 @@ private:
     // Mesure une valeur sur un mobile.
     double value(unsigned int valType, const Piston& piston);
     double valuePopulation(unsigned int valType, State& state, const Polygone& polygone, unsigned int& nbre);
-    double value(unsigned int valType, const Boule& boule);
-    double profilValue(unsigned int valType, const Boule& boule);
+    double value(unsigned int valType, const State& state, unsigned int rang);
+    double profilValue(unsigned int valType, const Particules& particules, unsigned int rang);
 
     // Ensemble représenté.
     unsigned int mType;
@@ -18,8 +18,14 @@
 
 #include "dispatcher.hpp"
 
+#include <algorithm>
+#include <QCoreApplication>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 #include "document.hpp"
 
+constexpr int Dispatcher::dureePas;
+
 // Un unique objet est construit pour l'application.
 Dispatcher Dispatcher::obj;
 
@@ -28,7 +34,8 @@ Dispatcher::Dispatcher() :
     mRunning(false),
     mSimulStep(false),
     mWaitClose(false),
-    mWaitCloseAll(false)
+    mWaitCloseAll(false),
+    mTranche(dureePas)
 {
 }
 
@@ -142,7 +149,11 @@ void Dispatcher::run()
             if (it.value())
                 mSetPlay.insert(it.key());
             else
+            {
+                // Dessine le dernier instantané, publié pendant le dernier pas.
                 mSetPlay.remove(it.key());
+                it.key()->mSimulateur->refreshDrawing();
+            }
             it.key()->mPlaying = it.value();
         }
         mWaitPlay.clear();
@@ -166,10 +177,25 @@ void Dispatcher::run()
             emit readyCloseActive();
         }
 
-        // Avance chaque simulation jusqu'au prochain dessin.
+        // Avance chaque simulation jusqu'au prochain dessin, chacune sur un thread de calcul.
+        // Les documents étant indépendants, seule l'interface graphique doit attendre la fin du pas.
+        // Le temps de calcul est partagé équitablement : chaque simulation reçoit la même tranche, réduite
+        // lorsqu'il y a plus de simulations que de threads, pour que la durée d'un pas reste bornée.
         mSimulStep = true;
-        for (auto& it : mSetPlay)
-            it->mSimulateur->playToNextDraw();
+        QList<Document*> docs = mSetPlay.values();
+        int threads = QThreadPool::globalInstance()->maxThreadCount();
+        mTranche = docs.size() > threads ? std::max(1, dureePas * threads / docs.size()) : dureePas;
+        QFuture<void> pas = QtConcurrent::map(docs, &Dispatcher::playSlice);
+
+        // Pendant le calcul, dessine le dernier instantané publié par chaque simulation.
+        for (auto& it : docs)
+            it->mSimulateur->refreshDrawing();
+        pas.waitForFinished();
+
+        // Met à jour l'interface graphique, les requêtes reçues étant mises en file d'attente.
+        for (auto& it : docs)
+            it->mSimulateur->refreshView();
+        QCoreApplication::processEvents();
         mSimulStep = false;
     }
 
@@ -187,3 +213,9 @@ void Dispatcher::run()
     // On indique que l'on sort de la boucle principale.
     mRunning = false;
 }
+
+// Avance une simulation pendant une tranche de temps (exécuté par un thread de calcul).
+void Dispatcher::playSlice(Document*& doc)
+{
+    doc->mSimulateur->playSlice(obj.mTranche);
+}
@@ -58,12 +58,19 @@ private:
 
     // Lance la boucle principale de simulation.
     void run();
+    // Avance une simulation pendant une tranche de temps (exécuté par un thread de calcul).
+    static void playSlice(Document*& doc);
+
+    // Durée d'un pas de la boucle principale (en millisecondes), partagée entre les simulations en cours.
+    static constexpr int dureePas = 40;
 
     // Etat global.
     bool mRunning;
     bool mSimulStep;
     bool mWaitClose;
     bool mWaitCloseAll;
+    // Temps de calcul accordé à chaque simulation pendant le pas en cours (en millisecondes).
+    int mTranche;
 
     // Liste des documents dans la file d'attente.
     QSet<Document*> mSetPlay;
@@ -20,8 +20,8 @@
 
 #include "state.hpp"
 
-// Calcule et ajoute une valeur à la courbe.
-void Courbe::push(unsigned int valType, bool mean, State& state)
+// Calcule une valeur de la courbe (sans la modifier).
+double Courbe::mesure(unsigned int valType, bool mean, State& state) const
 {
     unsigned int nbre = 0;
     double valeur = 0;
@@ -31,7 +31,7 @@ void Courbe::push(unsigned int valType, bool mean, State& state)
 
     if (mean)
         valeur /= nbre;
-    this->push(state.now, valeur);
+    return valeur;
 }
 
 // Ajoute une valeur à la courbe.
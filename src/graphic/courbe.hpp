@@ -31,8 +31,10 @@ public:
     // Constructeur.
     inline Courbe(const ConfigCourbe& config);
 
-    // Calcule et ajoute une valeur à la courbe.
-    void push(unsigned int valType, bool mean, State& state);
+    // Calcule une valeur de la courbe (sans la modifier).
+    double mesure(unsigned int valType, bool mean, State& state) const;
+    // Ajoute une valeur à la courbe.
+    void push(Time time, double valeur);
 
     // Accesseurs.
     inline const QList<std::pair<Time, double> >& valeurs() const;
@@ -43,9 +45,6 @@ public:
     double min() const;
 
 private:
-    // Ajoute une valeur à la courbe.
-    void push(Time time, double valeur);
-
     // Valeurs de la courbe.
     QList<std::pair<Time, double> > mValeurs;
     // Configuration.
@@ -82,18 +82,31 @@ void CourbesGroup::addProfil(const ConfigProfil& profil)
 }
 
 
-// Ajoute des valeurs aux courbes.
-void CourbesGroup::push(State& state)
+// Calcule des valeurs des courbes (sans les modifier).
+CourbesGroup::Mesure CourbesGroup::mesure(State& state) const
 {
+    Mesure mesure;
+    mesure.mInstant = state.instant();
     for (auto& courbe : mCourbes)
-        courbe->push(state);
+        mesure.mCourbes.append(courbe->mesure(state));
     for (auto& profil : mProfils)
-        profil->push(state);
+        mesure.mProfils.append(profil->mesure(state));
+    return mesure;
+}
 
-    if (state.now < mBegin)
-        mBegin = state.now;
-    if (mEnd.isNever() || mEnd < state.now)
-        mEnd = state.now;
+// Ajoute des valeurs aux courbes.
+void CourbesGroup::push(const Mesure& mesure)
+{
+    for (int i = 0 ; i < mCourbes.size() ; ++i)
+        mCourbes[i]->push(mesure.mInstant, mesure.mCourbes[i]);
+    for (int i = 0 ; i < mProfils.size() ; ++i)
+        mProfils[i]->push(mesure.mInstant, mesure.mProfils[i]);
+
+    Time instant = mesure.mInstant;
+    if (instant < mBegin)
+        mBegin = instant;
+    if (mEnd.isNever() || mEnd < instant)
+        mEnd = instant;
 }
 
 // Met à jour la barre de défilement.
@@ -31,6 +31,14 @@ class CourbesGroup : public QWidget
     Q_OBJECT
 
 public:
+    // Valeurs mesurées à un instant, pour chaque courbe et chaque profil.
+    struct Mesure
+    {
+        Time mInstant;
+        QList<QList<double> > mCourbes;
+        QList<QMap<int, double> > mProfils;
+    };
+
     // Constructeur.
     CourbesGroup(Time lifespan);
 
@@ -39,8 +47,10 @@ public:
     void addCourbe(const ConfigWidgetCourbe& courbe);
     void addProfil(const ConfigProfil& profil);
 
+    // Calcule des valeurs des courbes (sans les modifier, peut être appelé depuis un thread de calcul).
+    Mesure mesure(State& state) const;
     // Ajoute des valeurs aux courbes.
-    void push(State& state);
+    void push(const Mesure& mesure);
     void update();
 
 private slots:
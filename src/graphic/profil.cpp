@@ -21,8 +21,8 @@
 #include <limits>
 #include "state.hpp"
 
-// Calcule et ajoute une tranche au profil.
-void Profil::push(State& state)
+// Calcule une tranche du profil (sans le modifier).
+QMap<int, double> Profil::mesure(State& state) const
 {
     QMap<int, unsigned int> nbres;
     QMap<int, double> valeurs;
@@ -33,7 +33,7 @@ void Profil::push(State& state)
     if (mConfig.mMean)
         for (auto it = valeurs.begin() ; it != valeurs.end() ; ++it)
             it.value() /= nbres[it.key()];
-    this->push(state.now, valeurs);
+    return valeurs;
 }
 
 // Ajoute une tranche au profil.
@@ -33,8 +33,10 @@ public:
     // Constructeur.
     inline Profil(const ConfigProfil& config);
 
-    // Calcule et ajoute une tranche au profil.
-    void push(State& state);
+    // Calcule une tranche du profil (sans le modifier).
+    QMap<int, double> mesure(State& state) const;
+    // Ajoute une tranche au profil.
+    void push(Time time, const QMap<int, double>& valeur);
 
     // Accesseurs.
     inline const QList<std::pair<Time, QMap<int, double> > >& valeurs() const;
@@ -46,9 +48,6 @@ public:
     double max() const;
 
 private:
-    // Ajoute une tranche au profil.
-    void push(Time time, const QMap<int, double>& valeur);
-
     // Valeurs du profil.
     QList<std::pair<Time, QMap<int, double> > > mValeurs;
     // Configuration.
@@ -56,11 +56,20 @@ void WidgetCourbe::resizeEvent(QResizeEvent*/* event*/)
 }
 
 
-// Calcule et ajoute des valeurs aux courbes.
-void WidgetCourbe::push(State& state)
+// Calcule des valeurs des courbes (sans les modifier).
+QList<double> WidgetCourbe::mesure(State& state) const
 {
+    QList<double> valeurs;
     for (auto& courbe : mCourbes)
-        courbe.push(mConfig.mType, mConfig.mMean, state);
+        valeurs.append(courbe.mesure(mConfig.mType, mConfig.mMean, state));
+    return valeurs;
+}
+
+// Ajoute des valeurs aux courbes.
+void WidgetCourbe::push(Time time, const QList<double>& valeurs)
+{
+    for (int i = 0 ; i < mCourbes.size() ; ++i)
+        mCourbes[i].push(time, valeurs[i]);
 }
 
 // Redessine la QPixmap.
@@ -31,8 +31,10 @@ public:
     // Construteur.
     WidgetCourbe(Time lifespan, const ConfigWidgetCourbe& config);
 
-    // Calcule et ajoute des valeurs aux courbes.
-    void push(State& state);
+    // Calcule des valeurs des courbes (sans les modifier).
+    QList<double> mesure(State& state) const;
+    // Ajoute des valeurs aux courbes.
+    void push(Time time, const QList<double>& valeurs);
     // Redessine la QPixmap.
     void update();
 
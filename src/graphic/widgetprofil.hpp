@@ -29,8 +29,10 @@ public:
     // Construteur.
     WidgetProfil(Time lifespan, const ConfigProfil& config);
 
-    // Calcule et ajoute une tranche au profil.
-    inline void push(State& state);
+    // Calcule une tranche du profil (sans le modifier).
+    inline QMap<int, double> mesure(State& state) const;
+    // Ajoute une tranche au profil.
+    inline void push(Time time, const QMap<int, double>& valeur);
     // Redessine la QPixmap.
     void update();
 
@@ -54,9 +56,12 @@ private:
     Profil mProfil;
 };
 
-// Calcule et ajoute une tranche au profil.
-inline void WidgetProfil::push(State& state)
-    {mProfil.push(state);}
+// Calcule une tranche du profil (sans le modifier).
+inline QMap<int, double> WidgetProfil::mesure(State& state) const
+    {return mProfil.mesure(state);}
+// Ajoute une tranche au profil.
+inline void WidgetProfil::push(Time time, const QMap<int, double>& valeur)
+    {mProfil.push(time, valeur);}
 // Accesseurs.
 inline void WidgetProfil::setScroll(double scroll)
     {mScroll = scroll;}
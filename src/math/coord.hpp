@@ -19,6 +19,12 @@
 #ifndef COORD_HPP
 #define COORD_HPP
 
+#include <algorithm>
+#include <cmath>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 // la class Coord décrit un vecteur de dimension 2
 template <typename T>
 class Coord
@@ -88,6 +94,8 @@ public:
 
     // ordre lexicographique
     bool operator<(const Coord<T>& coord) const;
+    // appartenance au rectangle [min, max]
+    bool inside(const Coord<T>& min, const Coord<T>& max) const;
 
     // addition de vecteurs
     void operator+=(const Coord<T>& coord);
@@ -128,6 +136,8 @@ public:
     T invCoeffDir() const;
     // x * y
     T product() const;
+    // multiplication-addition : *this + coord * ratio
+    Coord<T> addMul(const Coord<T>& coord, const T& ratio) const;
     // _x = x * x' - y * y'
     // _y = x * y' + y * x'
     Coord<T> complexProduct(const Coord<T>& coord) const;
@@ -153,4 +163,422 @@ public:
     T y;
 };
 
+// spécialisation pour les vecteurs de réels, utilisée par les calculs de trajectoire et de collision
+// les deux composantes sont stockées de manière alignée et traitées ensemble par les instructions SSE2
+// toutes les méthodes sont inline, de sorte qu'elles sont disponibles sans inclure coord.tpl
+template <>
+class Coord<double>
+{
+public:
+    // vecteur nul
+    constexpr Coord();
+    // vecteur
+    constexpr Coord(double X, double Y);
+    // y = x
+    constexpr explicit Coord(double X);
+
+    // transtypage
+    template <typename _T>
+    constexpr explicit Coord(const Coord<_T>& coord);
+
+    // x == y ?
+    constexpr bool isSquare() const;
+    // compare les vecteurs
+    constexpr bool operator==(const Coord<double>& coord) const;
+    constexpr bool operator!=(const Coord<double>& coord) const;
+
+    // ordre lexicographique
+    constexpr bool operator<(const Coord<double>& coord) const;
+    // appartenance au rectangle [min, max]
+    constexpr bool inside(const Coord<double>& min, const Coord<double>& max) const;
+
+    // addition de vecteurs
+    inline void operator+=(const Coord<double>& coord);
+    inline void operator+=(double move);
+    inline Coord<double> operator+(const Coord<double>& coord) const;
+    inline Coord<double> operator+(double move) const;
+    // soustraction de vecteurs
+    inline void operator-=(const Coord<double>& coord);
+    inline Coord<double> operator-(const Coord<double>& coord) const;
+    constexpr Coord<double> operator-() const;
+    // multiplie chaque composante du vecteur par la même composante de l'autre vecteur
+    inline void operator*=(const Coord<double>& coord);
+    inline Coord<double> operator*(const Coord<double>& coord) const;
+    // multiplie chaque composante du vecteur par le ratio
+    inline void operator*=(double ratio);
+    inline Coord<double> operator*(double ratio) const;
+    // divise chaque composante du vecteur par la même composante de l'autre vecteur
+    inline void operator/=(const Coord<double>& coord);
+    inline Coord<double> operator/(const Coord<double>& coord) const;
+    // divise chaque composante du vecteur par le ratio
+    inline void operator/=(double ratio);
+    inline Coord<double> operator/(double ratio) const;
+
+    // _x = min(x, x')
+    // _y = min(y, y')
+    inline Coord<double> min(const Coord<double>& coord) const;
+    // _x = max(x, x')
+    // _y = max(y, y')
+    inline Coord<double> max(const Coord<double>& coord) const;
+
+    // produit scalaire : x * x' + y * y'
+    inline double scalar(const Coord<double>& coord) const;
+    // determinant : x * y' - y * x'
+    inline double det(const Coord<double>& coord) const;
+    // coefficient directeur : y / x
+    constexpr double coeffDir() const;
+    // inverse du coefficient directeur : x / y
+    constexpr double invCoeffDir() const;
+    // x * y
+    constexpr double product() const;
+    // multiplication-addition : *this + coord * ratio
+    // les deux opérations sont arrondies séparément, comme l'expression équivalente
+    inline Coord<double> addMul(const Coord<double>& coord, double ratio) const;
+    // _x = x * x' - y * y'
+    // _y = x * y' + y * x'
+    inline Coord<double> complexProduct(const Coord<double>& coord) const;
+    // racine carrée complexe
+    inline Coord<double> complexSqrt() const;
+    // conjugué complexe
+    constexpr Coord<double> conj() const;
+    // x^2 + y^2, i.e. module au carré
+    inline double squareLength() const;
+    // longueur du vecteur, i.e. module
+    inline double length() const;
+    // arctangente, i.e. argument
+    inline double atan() const;
+    // cosinus, i.e. x / length()
+    inline double cos() const;
+    // sinus, i.e. y / length()
+    inline double sin() const;
+
+    // les 2 composantes du vecteur
+    alignas(16) double x;
+    double y;
+
+#ifdef __SSE2__
+private:
+    // conversions depuis et vers un registre SSE2 (x dans la partie basse, y dans la partie haute)
+    inline explicit Coord(__m128d v);
+    inline __m128d v() const;
+    // somme des deux composantes d'un registre
+    static inline double somme(__m128d v);
+#endif
+};
+
+
+// vecteur nul
+constexpr Coord<double>::Coord() :
+    x(0),
+    y(0)
+{
+}
+
+// vecteur
+constexpr Coord<double>::Coord(double X, double Y) :
+    x(X),
+    y(Y)
+{
+}
+
+// y = x
+constexpr Coord<double>::Coord(double X) :
+    x(X),
+    y(X)
+{
+}
+
+// transtypage
+template <typename _T>
+constexpr Coord<double>::Coord(const Coord<_T>& coord) :
+    x(double(coord.x)),
+    y(double(coord.y))
+{
+}
+
+#ifdef __SSE2__
+// conversions depuis et vers un registre SSE2
+inline Coord<double>::Coord(__m128d v)
+{
+    _mm_store_pd(&x, v);
+}
+
+inline __m128d Coord<double>::v() const
+{
+    return _mm_load_pd(&x);
+}
+
+// somme des deux composantes d'un registre : x + y
+inline double Coord<double>::somme(__m128d v)
+{
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+#endif
+
+
+// x == y ?
+constexpr bool Coord<double>::isSquare() const
+{
+    return x == y;
+}
+
+// compare les vecteurs
+constexpr bool Coord<double>::operator==(const Coord<double>& coord) const
+{
+    return x == coord.x && y == coord.y;
+}
+
+constexpr bool Coord<double>::operator!=(const Coord<double>& coord) const
+{
+    return x != coord.x || y != coord.y;
+}
+
+
+// ordre lexicographique
+constexpr bool Coord<double>::operator<(const Coord<double>& coord) const
+{
+    return x == coord.x ? y < coord.y : x < coord.x;
+}
+
+// appartenance au rectangle [min, max]
+constexpr bool Coord<double>::inside(const Coord<double>& min, const Coord<double>& max) const
+{
+    return x >= min.x && x <= max.x && y >= min.y && y <= max.y;
+}
+
+
+// addition de vecteurs
+inline void Coord<double>::operator+=(const Coord<double>& coord)
+{
+    *this = *this + coord;
+}
+
+inline void Coord<double>::operator+=(double move)
+{
+    *this = *this + move;
+}
+
+inline Coord<double> Coord<double>::operator+(const Coord<double>& coord) const
+{
+#ifdef __SSE2__
+    return Coord<double>(_mm_add_pd(this->v(), coord.v()));
+#else
+    return Coord<double>(x + coord.x, y + coord.y);
+#endif
+}
+
+inline Coord<double> Coord<double>::operator+(double move) const
+{
+#ifdef __SSE2__
+    return Coord<double>(_mm_add_pd(this->v(), _mm_set1_pd(move)));
+#else
+    return Coord<double>(x + move, y + move);
+#endif
+}
+
+// soustraction de vecteurs
+inline void Coord<double>::operator-=(const Coord<double>& coord)
+{
+    *this = *this - coord;
+}
+
+inline Coord<double> Coord<double>::operator-(const Coord<double>& coord) const
+{
+#ifdef __SSE2__
+    return Coord<double>(_mm_sub_pd(this->v(), coord.v()));
+#else
+    return Coord<double>(x - coord.x, y - coord.y);
+#endif
+}
+
+constexpr Coord<double> Coord<double>::operator-() const
+{
+    return Coord<double>(-x, -y);
+}
+
+// multiplie chaque composante du vecteur par la même composante de l'autre vecteur
+inline void Coord<double>::operator*=(const Coord<double>& coord)
+{
+    *this = *this * coord;
+}
+
+inline Coord<double> Coord<double>::operator*(const Coord<double>& coord) const
+{
+#ifdef __SSE2__
+    return Coord<double>(_mm_mul_pd(this->v(), coord.v()));
+#else
+    return Coord<double>(x * coord.x, y * coord.y);
+#endif
+}
+
+// multiplie chaque composante du vecteur par le ratio
+inline void Coord<double>::operator*=(double ratio)
+{
+    *this = *this * ratio;
+}
+
+inline Coord<double> Coord<double>::operator*(double ratio) const
+{
+#ifdef __SSE2__
+    return Coord<double>(_mm_mul_pd(this->v(), _mm_set1_pd(ratio)));
+#else
+    return Coord<double>(x * ratio, y * ratio);
+#endif
+}
+
+// divise chaque composante du vecteur par la même composante de l'autre vecteur
+inline void Coord<double>::operator/=(const Coord<double>& coord)
+{
+    *this = *this / coord;
+}
+
+inline Coord<double> Coord<double>::operator/(const Coord<double>& coord) const
+{
+#ifdef __SSE2__
+    return Coord<double>(_mm_div_pd(this->v(), coord.v()));
+#else
+    return Coord<double>(x / coord.x, y / coord.y);
+#endif
+}
+
+// divise chaque composante du vecteur par le ratio
+inline void Coord<double>::operator/=(double ratio)
+{
+    *this = *this / ratio;
+}
+
+inline Coord<double> Coord<double>::operator/(double ratio) const
+{
+#ifdef __SSE2__
+    return Coord<double>(_mm_div_pd(this->v(), _mm_set1_pd(ratio)));
+#else
+    return Coord<double>(x / ratio, y / ratio);
+#endif
+}
+
+
+// _x = min(x, x')
+// _y = min(y, y')
+// l'ordre des opérandes reproduit std::min (en cas d'égalité, la composante de *this est conservée)
+inline Coord<double> Coord<double>::min(const Coord<double>& coord) const
+{
+#ifdef __SSE2__
+    return Coord<double>(_mm_min_pd(coord.v(), this->v()));
+#else
+    return Coord<double>(std::min(x, coord.x), std::min(y, coord.y));
+#endif
+}
+
+// _x = max(x, x')
+// _y = max(y, y')
+inline Coord<double> Coord<double>::max(const Coord<double>& coord) const
+{
+#ifdef __SSE2__
+    return Coord<double>(_mm_max_pd(coord.v(), this->v()));
+#else
+    return Coord<double>(std::max(x, coord.x), std::max(y, coord.y));
+#endif
+}
+
+
+// produit scalaire : x * x' + y * y'
+inline double Coord<double>::scalar(const Coord<double>& coord) const
+{
+#ifdef __SSE2__
+    return somme(_mm_mul_pd(this->v(), coord.v()));
+#else
+    return x * coord.x + y * coord.y;
+#endif
+}
+
+// determinant : x * y' - y * x'
+inline double Coord<double>::det(const Coord<double>& coord) const
+{
+#ifdef __SSE2__
+    __m128d produit = _mm_mul_pd(this->v(), _mm_shuffle_pd(coord.v(), coord.v(), 1));
+    return _mm_cvtsd_f64(_mm_sub_sd(produit, _mm_unpackhi_pd(produit, produit)));
+#else
+    return x * coord.y - y * coord.x;
+#endif
+}
+
+// coefficient directeur : y / x
+constexpr double Coord<double>::coeffDir() const
+{
+    return y / x;
+}
+
+// inverse du coefficient directeur : x / y
+constexpr double Coord<double>::invCoeffDir() const
+{
+    return x / y;
+}
+
+// x * y
+constexpr double Coord<double>::product() const
+{
+    return x * y;
+}
+
+// multiplication-addition : *this + coord * ratio
+inline Coord<double> Coord<double>::addMul(const Coord<double>& coord, double ratio) const
+{
+#ifdef __SSE2__
+    return Coord<double>(_mm_add_pd(this->v(), _mm_mul_pd(coord.v(), _mm_set1_pd(ratio))));
+#else
+    return Coord<double>(x + coord.x * ratio, y + coord.y * ratio);
+#endif
+}
+
+// _x = x * x' - y * y'
+// _y = x * y' + y * x'
+inline Coord<double> Coord<double>::complexProduct(const Coord<double>& coord) const
+{
+    return Coord<double>(x * coord.x - y * coord.y, x * coord.y + y * coord.x);
+}
+
+// racine carrée complexe
+inline Coord<double> Coord<double>::complexSqrt() const
+{
+    double arg = this->atan() / 2;
+    double mod = this->length();
+    return Coord<double>(mod * std::cos(arg), mod * std::sin(arg));
+}
+
+// conjugué complexe
+constexpr Coord<double> Coord<double>::conj() const
+{
+    return Coord<double>(x, -y);
+}
+
+// x^2 + y^2, i.e. module au carré
+inline double Coord<double>::squareLength() const
+{
+    return this->scalar(*this);
+}
+
+// longueur du vecteur, i.e. module
+inline double Coord<double>::length() const
+{
+    return std::sqrt(this->squareLength());
+}
+
+// arctangente, i.e. argument
+inline double Coord<double>::atan() const
+{
+    return std::atan2(y, x);
+}
+
+// cosinus de l'argument, i.e. x / length()
+inline double Coord<double>::cos() const
+{
+    return x / this->length();
+}
+
+// sinus de l'argument, i.e. y / length()
+inline double Coord<double>::sin() const
+{
+    return y / this->length();
+}
+
 #endif // COORD_HPP
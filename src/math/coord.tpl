@@ -130,6 +130,13 @@ bool Coord<T>::operator<(const Coord<T>& coord) const
     return x == coord.x ? y < coord.y : x < coord.x;
 }
 
+// appartenance au rectangle [min, max]
+template <typename T>
+bool Coord<T>::inside(const Coord<T>& min, const Coord<T>& max) const
+{
+    return x >= min.x && x <= max.x && y >= min.y && y <= max.y;
+}
+
 
 // addition de vecteurs
 template <typename T>
@@ -301,6 +308,13 @@ T Coord<T>::product() const
     return x * y;
 }
 
+// multiplication-addition : *this + coord * ratio
+template <typename T>
+Coord<T> Coord<T>::addMul(const Coord<T>& coord, const T& ratio) const
+{
+    return *this + coord * ratio;
+}
+
 // _x = x * x' - y * y'
 // _y = x * y' + y * x'
 template <typename T>
@@ -0,0 +1,99 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "quadratiques.hpp"
+
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+#include "solveur.hpp"
+
+// Constructeur.
+Quadratiques::Quadratiques() :
+    mA(), mB(), mC(), mRacines()
+{
+}
+
+
+// Calcule le premier instant d'approche de chaque équation (même résultat que Solveur::fstApproche, -1 si aucun).
+// Les opérations sont celles de la version scalaire, dans le même ordre : les résultats sont identiques.
+void Quadratiques::fstApproches()
+{
+    const unsigned int n = mA.size();
+    mRacines.resize(n);
+    unsigned int i = 0;
+
+#ifdef __AVX__
+    // Quatre équations à la fois.
+    {
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d deux = _mm256_set1_pd(2.0);
+        const __m256d quatre = _mm256_set1_pd(4.0);
+        const __m256d moinsUn = _mm256_set1_pd(-1.0);
+
+        for ( ; i + 4 <= n ; i += 4)
+        {
+            __m256d a = _mm256_loadu_pd(&mA[i]);
+            __m256d b = _mm256_loadu_pd(&mB[i]);
+            __m256d c = _mm256_loadu_pd(&mC[i]);
+
+            // Discriminant et racine.
+            __m256d delta = _mm256_sub_pd(_mm256_mul_pd(b, b), _mm256_mul_pd(_mm256_mul_pd(quatre, a), c));
+            __m256d x = _mm256_div_pd(_mm256_mul_pd(deux, c), _mm256_sub_pd(_mm256_sqrt_pd(delta), b));
+            x = _mm256_max_pd(zero, x);
+
+            // -1 si le trinôme ne décroît pas, ou si le discriminant est négatif.
+            __m256d valide = _mm256_and_pd(_mm256_cmp_pd(b, zero, _CMP_LT_OQ), _mm256_cmp_pd(delta, zero, _CMP_GE_OQ));
+            x = _mm256_blendv_pd(moinsUn, x, valide);
+            _mm256_storeu_pd(&mRacines[i], x);
+        }
+    }
+#endif
+
+#ifdef __SSE2__
+    // Deux équations à la fois.
+    {
+        const __m128d zero = _mm_setzero_pd();
+        const __m128d deux = _mm_set1_pd(2.0);
+        const __m128d quatre = _mm_set1_pd(4.0);
+        const __m128d moinsUn = _mm_set1_pd(-1.0);
+
+        for ( ; i + 2 <= n ; i += 2)
+        {
+            __m128d a = _mm_loadu_pd(&mA[i]);
+            __m128d b = _mm_loadu_pd(&mB[i]);
+            __m128d c = _mm_loadu_pd(&mC[i]);
+
+            // Discriminant et racine.
+            __m128d delta = _mm_sub_pd(_mm_mul_pd(b, b), _mm_mul_pd(_mm_mul_pd(quatre, a), c));
+            __m128d x = _mm_div_pd(_mm_mul_pd(deux, c), _mm_sub_pd(_mm_sqrt_pd(delta), b));
+            x = _mm_max_pd(zero, x);
+
+            // -1 si le trinôme ne décroît pas, ou si le discriminant est négatif.
+            __m128d valide = _mm_and_pd(_mm_cmplt_pd(b, zero), _mm_cmpge_pd(delta, zero));
+            x = _mm_or_pd(_mm_and_pd(valide, x), _mm_andnot_pd(valide, moinsUn));
+            _mm_storeu_pd(&mRacines[i], x);
+        }
+    }
+#endif
+
+    // Equations restantes.
+    for ( ; i < n ; ++i)
+        mRacines[i] = Solveur::fstApproche(mA[i], mB[i], mC[i]);
+}
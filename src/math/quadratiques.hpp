@@ -0,0 +1,78 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef QUADRATIQUES_HPP
+#define QUADRATIQUES_HPP
+
+#include <vector>
+
+// Lot d'équations du second degré a.x² + b.x + c = 0, résolues ensemble.
+// Les coefficients sont rangés en tableaux contigus, ce qui permet de traiter plusieurs équations par instruction
+// (SSE2, ou AVX si le compilateur le cible) ; les équations restantes sont résolues une à une.
+// L'appelant fournit les coefficients (voir Boule::equation) et lit le résultat de chaque équation :
+// le lot ne retient pas la plus petite, car une boule garde toutes ses collisions prévues, pas seulement la première.
+class Quadratiques
+{
+public:
+    // Constructeur.
+    Quadratiques();
+
+    // Vide le lot.
+    inline void clear();
+    // Ajoute une équation.
+    inline void add(double a, double b, double c);
+
+    // Calcule le premier instant où chaque trinôme s'annule en décroissant
+    // (même résultat que Solveur::fstApproche, -1 si aucun).
+    void fstApproches();
+
+    // Accesseurs.
+    inline unsigned int size() const;
+    inline double racine(unsigned int i) const;
+
+private:
+    // Coefficients et racines.
+    std::vector<double> mA;
+    std::vector<double> mB;
+    std::vector<double> mC;
+    std::vector<double> mRacines;
+};
+
+// Vide le lot.
+inline void Quadratiques::clear()
+{
+    mA.clear();
+    mB.clear();
+    mC.clear();
+}
+
+// Ajoute une équation.
+inline void Quadratiques::add(double a, double b, double c)
+{
+    mA.push_back(a);
+    mB.push_back(b);
+    mC.push_back(c);
+}
+
+// Accesseurs.
+inline unsigned int Quadratiques::size() const
+    {return mA.size();}
+inline double Quadratiques::racine(unsigned int i) const
+    {return mRacines[i];}
+
+#endif // QUADRATIQUES_HPP
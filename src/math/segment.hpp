@@ -19,6 +19,7 @@
 #ifndef SEGMENT_HPP
 #define SEGMENT_HPP
 
+#include <algorithm>
 #include <iostream>
 #include "coord.tpl"
 
@@ -40,13 +41,21 @@ public:
     inline const Coord<double>& vect() const;
     // Vecteur : point - p1.
     inline Coord<double> vect(const Coord<double>& point) const;
+    // Extrémités.
+    inline const Coord<double>& debut() const;
+    inline Coord<double> fin() const;
 
-    // Longueur du segment.
+    // Longueur du segment (précalculée).
     inline double length() const;
     inline double squareLength() const;
+    // Vecteur unitaire associé et normale unitaire (précalculés).
+    inline const Coord<double>& unitaire() const;
+    inline Coord<double> normale() const;
 
     // Vérifie si la projection orthogonale d'un point est sur le segment.
     bool face(const Coord<double>& point) const;
+    // Vérifie si le rectangle englobant le segment recoupe le rectangle [min, max].
+    inline bool boxIntersect(const Coord<double>& min, const Coord<double>& max) const;
 
     // Case du quadrillage de pas "sizeArea" contenant le point.
     inline Coord<int> point1(double sizeArea) const;
@@ -59,12 +68,15 @@ public:
 private:
     Coord<double> mPoint1;
     Coord<double> mVecteur;
+    // Données précalculées.
+    double mLength;
+    Coord<double> mUnitaire;
 };
 
 // Constructeurs.
 inline Segment::Segment() {}
 inline Segment::Segment(const Coord<double>& point1, const Coord<double>& point2) :
-    mPoint1(point1), mVecteur(point2 - point1) {}
+    mPoint1(point1), mVecteur(point2 - point1), mLength(mVecteur.length()), mUnitaire(mLength > 0 ? mVecteur / mLength : mVecteur) {}
 
 // Comparaison lexicographique.
 inline bool Segment::operator<(const Segment& segment) const
@@ -77,12 +89,30 @@ inline const Coord<double>& Segment::vect() const
 // Vecteur : point - p1.
 inline Coord<double> Segment::vect(const Coord<double>& point) const
     {return point - mPoint1;}
+// Extrémités.
+inline const Coord<double>& Segment::debut() const
+    {return mPoint1;}
+inline Coord<double> Segment::fin() const
+    {return mPoint1 + mVecteur;}
 
-// Longueur du segment.
+// Longueur du segment (précalculée).
 inline double Segment::length() const
-    {return mVecteur.length();}
+    {return mLength;}
 inline double Segment::squareLength() const
     {return mVecteur.squareLength();}
+// Vecteur unitaire associé et normale unitaire (précalculés).
+inline const Coord<double>& Segment::unitaire() const
+    {return mUnitaire;}
+inline Coord<double> Segment::normale() const
+    {return Coord<double>(mUnitaire.y, -mUnitaire.x);}
+
+// Vérifie si le rectangle englobant le segment recoupe le rectangle [min, max].
+inline bool Segment::boxIntersect(const Coord<double>& min, const Coord<double>& max) const
+{
+    Coord<double> fin = this->fin();
+    return std::max(mPoint1.x, fin.x) >= min.x && std::min(mPoint1.x, fin.x) <= max.x
+        && std::max(mPoint1.y, fin.y) >= min.y && std::min(mPoint1.y, fin.y) <= max.y;
+}
 
 // Case du quadrillage de pas "sizeArea" contenant le point.
 inline Coord<int> Segment::point1(double sizeArea) const
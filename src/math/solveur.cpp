@@ -18,19 +18,9 @@
 
 #include "solveur.hpp"
 
+#include <algorithm>
 #include <cmath>
-#include <ctime>
-
-// Générateur de nombres aléatoires.
-std::mt19937& Solveur::generateur = Solveur::makeGenerateur();
-
-std::mt19937& Solveur::makeGenerateur()
-{
-    static std::mt19937 generateur;
-    generateur.seed(std::time(0));
-    return generateur;
-}
-
+#include <limits>
 
 // Degré 2.
 void Solveur::quadratique(const std::complex<double>& a, const std::complex<double>& b, const std::complex<double>& c, std::complex<double>& z0, std::complex<double>& z1)
@@ -180,3 +170,115 @@ double Solveur::fstQuartique(double a, double b, double c, double d, double e)
 
     return result;
 }
+
+// Premier instant positif où le polynôme (coefficient dominant positif) devient négatif, avant la limite (-1 sinon).
+// Pour un contact, le polynôme est le carré de la distance moins celui du rayon : la racine cherchée est la première
+// d'un intervalle où il décroît. Les intervalles de monotonie sont délimités par les racines de la dérivée, isolées
+// par celles de la dérivée seconde (équation du second degré) ; chaque racine est affinée par Newton, protégé par
+// dichotomie. Les intervalles sont parcourus dans l'ordre, jusqu'à la racine ou la limite.
+// Contrairement à la méthode de Ferrari, ce calcul reste précis près des racines doubles (contacts rasants).
+// Comme pour fstApproche, un contact déjà atteint (polynôme négatif ou nul) qui se resserre est immédiat : les objets
+// qui se recoupent à cause d'erreurs d'arrondi sont séparés au lieu de se traverser.
+double Solveur::fstContact(double a, double b, double c, double d, double e, double limite)
+{
+    if (e <= 0.0 && d < 0.0)
+        return 0.0;
+
+    const double p[5] = {a, b, c, d, e};
+    const double derivee[4] = {4 * a, 3 * b, 2 * c, d};
+
+    // Intervalles de monotonie de la dérivée : racines positives de la dérivée seconde, puis une borne au-delà
+    // de laquelle la dérivée n'a plus de racine.
+    double bornes[4];
+    unsigned int count = 0;
+    bornes[count++] = 0.0;
+    double delta = 9 * b * b - 24 * a * c;
+    if (delta > 0.0)
+    {
+        double rac = std::sqrt(delta);
+        double x1 = (-3 * b - rac) / (12 * a);
+        double x2 = (-3 * b + rac) / (12 * a);
+        if (x1 > 0.0)
+            bornes[count++] = x1;
+        if (x2 > 0.0)
+            bornes[count++] = x2;
+    }
+    double borne = 1.0 + std::max(std::abs(derivee[1]), std::max(std::abs(derivee[2]), std::abs(derivee[3]))) / derivee[0];
+    bornes[count] = std::max(borne, bornes[count - 1] + 1.0);
+    ++count;
+
+    // Parcourt les intervalles de monotonie du polynôme, séparés par les points critiques.
+    double tmp;
+    double debut = 0.0;
+    double valeur = Solveur::horner(p, 4, debut, tmp);
+    double pente = Solveur::horner(derivee, 3, bornes[0], tmp);
+
+    for (unsigned int i = 1 ; i < count && debut < limite ; ++i)
+    {
+        // Point critique (changement de signe de la dérivée) dans cet intervalle de monotonie de la dérivée.
+        double suivante = Solveur::horner(derivee, 3, bornes[i], tmp);
+        bool critique = (pente < 0.0 && suivante >= 0.0) || (pente > 0.0 && suivante <= 0.0);
+        pente = suivante;
+        if (!critique)
+            continue;
+        double fin = Solveur::monotone(derivee, 3, bornes[i - 1], bornes[i], 1e-9);
+
+        // Le polynôme devient négatif avant ce point critique.
+        double valeurFin = Solveur::horner(p, 4, fin, tmp);
+        if (valeur > 0.0 && valeurFin <= 0.0)
+        {
+            double result = Solveur::monotone(p, 4, debut, fin, 0.0);
+            return result < limite ? result : -1;
+        }
+
+        debut = fin;
+        valeur = valeurFin;
+    }
+
+    return -1;
+}
+
+// Valeur d'un polynôme de degré n (coefficients par degré décroissant), et de sa dérivée.
+double Solveur::horner(const double* p, unsigned int n, double x, double& derivee)
+{
+    double valeur = p[0];
+    derivee = 0.0;
+    for (unsigned int i = 1 ; i <= n ; ++i)
+    {
+        derivee = derivee * x + valeur;
+        valeur = valeur * x + p[i];
+    }
+    return valeur;
+}
+
+// Racine d'un polynôme monotone sur [debut, fin], changeant de signe entre les bornes (à la précision relative donnée).
+double Solveur::monotone(const double* p, unsigned int n, double debut, double fin, double precision)
+{
+    // Newton part de la borne inférieure (sans dépassement si le polynôme ne change pas de convexité).
+    double derivee;
+    bool croissant = Solveur::horner(p, n, debut, derivee) < Solveur::horner(p, n, fin, derivee);
+    double x = debut;
+
+    for (unsigned int i = 0 ; i < 100 ; ++i)
+    {
+        double valeur = Solveur::horner(p, n, x, derivee);
+        if (valeur == 0.0)
+            return x;
+
+        // Resserre l'intervalle autour de la racine.
+        if ((valeur < 0.0) == croissant)
+            debut = x;
+        else
+            fin = x;
+
+        // Pas de Newton, ou milieu de l'intervalle s'il en sort.
+        double next = x - valeur / derivee;
+        if (!(next > debut && next < fin))
+            next = (debut + fin) / 2.0;
+        if (std::abs(next - x) <= precision * x || next == x)
+            return next;
+        x = next;
+    }
+
+    return x;
+}
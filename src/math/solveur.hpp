@@ -19,8 +19,9 @@
 #ifndef SOLVEUR_HPP
 #define SOLVEUR_HPP
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
-#include <random>
 
 // Classe pour résoudre des équations polynomiales de degré inférieur ou égal à 4.
 class Solveur
@@ -30,24 +31,41 @@ public:
     static void quadratique(const std::complex<double>& a, const std::complex<double>& b, const std::complex<double>& c, std::complex<double>& z0, std::complex<double>& z1);
     static double fstQuadratique(double a, double b, double c);
     static double sndQuadratique(double a, double b, double c);
+    // Coefficient dominant positif ou nul : premier instant où le trinôme s'annule en décroissant
+    // (0 s'il est déjà négatif ou nul et décroissant, -1 s'il ne décroît pas).
+    static inline double fstApproche(double a, double b, double c);
     // Degré 3.
     static void cubique(double a, double b, double c, double d, std::complex<double>& z0, std::complex<double>& z1, std::complex<double>& z2);
     static double realCubique(double a, double b, double c, double d);
     // Degré 4.
     static void quartique(double a, double b, double c, double d, double e, std::complex<double>& z0, std::complex<double>& z1, std::complex<double>& z2, std::complex<double>& z3);
     static double fstQuartique(double a, double b, double c, double d, double e);
-
-    // Générateur de nombres aléatoires.
-    static std::mt19937& generateur;
+    // Coefficient dominant positif : premier instant positif où le polynôme devient négatif, avant la limite
+    // (0 s'il l'est déjà et décroît, -1 sinon).
+    static double fstContact(double a, double b, double c, double d, double e, double limite);
 
 private:
     // Fonctions utiles.
     static double racinecubique(double x);
     static double racinecubiquecomplex(std::complex<double> z);
     static void min(double& a, const std::complex<double>& b, double _a, double _b, double _c, double _d);
-
-    // Générateur de nombres aléatoires.
-    static std::mt19937& makeGenerateur();
+    // Valeur d'un polynôme de degré n (coefficients par degré décroissant), et de sa dérivée.
+    static double horner(const double* p, unsigned int n, double x, double& derivee);
+    // Racine d'un polynôme monotone sur [debut, fin], changeant de signe entre les bornes (à la précision relative donnée).
+    static double monotone(const double* p, unsigned int n, double debut, double fin, double precision);
 };
 
+// Premier instant où le trinôme s'annule en décroissant.
+// Un contact rasant (b nul) ou un éloignement ne donne jamais de collision, un chevauchement en cours d'approche
+// donne une collision immédiate. La racine est calculée sous la forme 2c / (-b + sqrt(delta)), qui n'additionne
+// que des termes de même signe (pas de perte de précision pour les contacts proches, et valable si a est nul).
+inline double Solveur::fstApproche(double a, double b, double c)
+{
+    double delta = b * b - 4.0 * a * c;
+
+    if (b < 0.0 && delta >= 0.0)
+        return std::max(2.0 * c / (std::sqrt(delta) - b), 0.0);
+    return -1;
+}
+
 #endif // SOLVEUR_HPP
@@ -18,27 +18,30 @@
 
 #include "boule.hpp"
 
+#include <algorithm>
 #include "coord_io.tpl"
 #include "state.hpp"
 
 // Constructeur.
 Boule::Boule(const Coord<double>& position, const Coord<double>& vitesse, const QColor& color, double masse, double rayon, State& state) :
-    Mobile(position, vitesse, color, masse),
+    Mobile(_boule, position, vitesse, color, masse, state),
     mOrigine(position),
     mOldFree(std::make_pair(Coord<double>(), Time())),
-    mLastFree(std::make_pair(position, state.now)),
+    mLastFree(std::make_pair(position, state.instant())),
     mRayon(rayon),
-    mArea(std::floor(position.x / state.sizeArea), std::floor(position.y / state.sizeArea)),
-    mMapIt(state.mapMobiles[mArea.y].boules().insert(mArea.x, this))
+    mLevel(state.niveau(rayon)),
+    mArea(state.grilles[mLevel].area(position)),
+    mCell(nullptr),
+    mCellIndex(0),
+    mLigne(nullptr),
+    mCleLigne(0.0),
+    mReference(position),
+    mVoisins(),
+    mRang(state.particules.add(position, vitesse, state.now, rayon, masse))
 {
-}
-
-
-// Avance le mobile jusqu'à l'instant indiqué (sans tenir compte des autres mobiles).
-void Boule::avance(const Time& time, const Coord<double>& gravity)
-{
-    mPosition += mVitesse * time.time() + gravity * time.time() * time.time() / 2;
-    mVitesse += gravity * time.time();
+    this->attachArea(state);
+    if (state.recherche == State::_voisins)
+        this->updateVoisins(state);
 }
 
 
@@ -59,7 +62,8 @@ void Boule::changePopulation(State& state)
 void Boule::setPopulation(unsigned int population, State& state)
 {
     mPopulation = population;
-    mEventIt = state.events.end();
+    mEventHandle = EventQueue::none;
+    state.particules.setPopulation(mRang, population);
 
     for (auto& mutation : state.config.configMutations())
     {
@@ -70,82 +74,37 @@ void Boule::setPopulation(unsigned int population, State& state)
             if (mutation.mType == ConfigReaction::proba)
             {
                 std::exponential_distribution<> distrib(1.0 / time);
-                time = distrib(Solveur::generateur);
+                time = distrib(state.generateur);
             }
 
             if (time > 0)
-                mEventIt = state.events.insert(
-                            std::make_pair(
-                                state.now + Time(time),
-                                std::make_shared<BouleEvent>(this)
-                            ));
+                mEventHandle = state.events.insert(state.now + Time(time), Event(Event::_boule, this->id()));
             break;
         }
     }
 }
 
 
-// Calcule l'instant de la prochaine collision avec le mobile.
-Time Boule::collision(const Mobile* mobile) const
-{
-    return mobile->collision(this);
-}
-
-Time Boule::collision(const Piston* piston) const
-{
-    // Différence de vitesse.
-    double dVitesseY = piston->mVitesse.y - mVitesse.y;
-    double dPositionY = mPosition.y - piston->mPosition.y;
-
-    // Les mobiles s'éloignent.
-    if (dVitesseY * dPositionY < 0.0)
-        return Time();
-
-    // Différence de position.
-    if (dPositionY >= 0.0)
-        dPositionY -= (mRayon + piston->epaisseur());
-    else
-        dPositionY += mRayon;
-
-    // Calcul de l'instant.
-    return Time(dPositionY / dVitesseY);
-}
-
-Time Boule::collision(const Boule* boule) const
-{
-    // Différence de vitesse et position.
-    Coord<double> dVitesse = mVitesse - boule->mVitesse;
-    Coord<double> dPosition = mPosition - boule->mPosition;
-
-    // Somme des rayons.
-    double rayons = mRayon + boule->mRayon;
-
-    // Résolution d'une équation du second degré.
-    return Solveur::fstQuadratique(
-                dVitesse.squareLength(),
-                2.0 * dVitesse.scalar(dPosition),
-                dPosition.squareLength() - rayons * rayons
-                );
-}
-
 // Calcule l'instant de la prochaine collision avec l'obstacle.
-Time Boule::collision(const Coord<double>& sommet, const Coord<double>& gravity) const
+Time Boule::collision(const Coord<double>& sommet, const Coord<double>& gravity, const Time& limite) const
 {
     // Différence de position.
     Coord<double> dPosition = mPosition - sommet;
 
-    // Avec gravité : équation de degré 4.
+    // Avec gravité : équation de degré 4 (carré de la distance au sommet moins celui du rayon, au cours de la parabole),
+    // dont seule la première racine avant la limite est cherchée.
     if (gravity != Coord<double>())
-        return Solveur::fstQuartique(
-                    gravity.squareLength(),
-                    2.0 * gravity.scalar(mVitesse),
-                    mVitesse.squareLength() + 2.0 * gravity.scalar(dPosition),
+        return Solveur::fstContact(
+                    gravity.squareLength() / 4.0,
+                    gravity.scalar(mVitesse),
+                    mVitesse.squareLength() + gravity.scalar(dPosition),
                     2.0 * mVitesse.scalar(dPosition),
-                    dPosition.squareLength() - mRayon * mRayon
+                    dPosition.squareLength() - mRayon * mRayon,
+                    limite.time()
                     );
-    // Sans gravité : équation du second degré.
+    // Sans gravité : équation du second degré (seul un rapprochement donne une collision).
     else
-        return Solveur::fstQuadratique(
+        return Solveur::fstApproche(
                     mVitesse.squareLength(),
                     2.0 * mVitesse.scalar(dPosition),
                     dPosition.squareLength() - mRayon * mRayon
@@ -182,7 +141,7 @@ Time Boule::collision(const Segment& segment, const Coord<double>& gravity) cons
         result = Solveur::fstQuadratique(detgrav, detvit, det);
 
     // Position au moment de la collision.
-    Coord<double> future(mPosition + mVitesse * result.time() + gravity * result.time() * result.time() / 2.0);
+    Coord<double> future(mPosition.addMul(mVitesse, result.time()) + gravity * result.time() * result.time() / 2.0);
 
     // Vérification que la collision sera dans l'intervalle du segment.
     if (segment.face(future))
@@ -190,70 +149,71 @@ Time Boule::collision(const Segment& segment, const Coord<double>& gravity) cons
     return Time();
 }
 
-// Calcule l'instant du prochain changement de zone.
-Time Boule::newArea(double sizeArea, const Coord<double>& gravity) const
+// Instant de sortie de la région, selon la politique de gravité (chaque axe est résolu séparément).
+template <typename Politique>
+Time Boule::sortieZone(Politique, const State& state) const
 {
-    Time result;
-    Time tmp;
+    // Bords de la zone.
+    const Coord<double>& gravity = state.config.gravity();
+    Coord<double> min;
+    Coord<double> max;
+    this->region(state, min, max);
+
+    Time x = Politique::horizontale ? Gravite::sortie(mPosition.x, mVitesse.x, gravity.x, min.x, max.x)
+                                    : Gravite::sortie(mPosition.x, mVitesse.x, min.x, max.x);
+    Time y = Politique::verticale ? Gravite::sortie(mPosition.y, mVitesse.y, gravity.y, min.y, max.y)
+                                  : Gravite::sortie(mPosition.y, mVitesse.y, min.y, max.y);
 
-    // Résolution selon le signe de la gravité.
-    if (gravity.x == 0.0)
-    {
-        if (mVitesse.x > 0)
-            result = ((mArea.x + 1) * sizeArea - mPosition.x) / mVitesse.x;
-        else if (mVitesse.x < 0)
-            result = (mArea.x * sizeArea - mPosition.x) / mVitesse.x;
-    }
-    else if (gravity.x < 0.0)
-    {
-        result = Solveur::fstQuadratique(gravity.x / 2.0, mVitesse.x, mPosition.x - (mArea.x + 1) * sizeArea);
-        tmp = Solveur::sndQuadratique(gravity.x / 2.0, mVitesse.x, mPosition.x - mArea.x * sizeArea);
-    }
-    else if (gravity.x > 0.0)
-    {
-        result = Solveur::sndQuadratique(gravity.x / 2.0, mVitesse.x, mPosition.x - (mArea.x + 1) * sizeArea);
-        tmp = Solveur::fstQuadratique(gravity.x / 2.0, mVitesse.x, mPosition.x - mArea.x * sizeArea);
-    }
     // Choix du plus proche temps.
-    if (tmp < result)
-        result = tmp;
+    return y < x ? y : x;
+}
 
-    // Résolution selon le signe de la gravité.
-    if (gravity.y == 0.0)
-    {
-        if (mVitesse.y > 0)
-            tmp = ((mArea.y + 1) * sizeArea - mPosition.y) / mVitesse.y;
-        else if (mVitesse.y < 0)
-            tmp = ((mArea.y) * sizeArea - mPosition.y) / mVitesse.y;
-    }
-    else if (gravity.y < 0.0)
+// Calcule l'instant du prochain changement de zone.
+Time Boule::newArea(const State& state) const
+{
+    return Gravite::applique(state.gravite, [&](auto politique) {return this->sortieZone(politique, state);});
+}
+
+// Rectangle balayé par la boule (rayon compris) d'ici la limite (faux s'il n'est pas borné).
+bool Boule::balayage(const Coord<double>& gravity, const Time& limite, Coord<double>& min, Coord<double>& max) const
+{
+    if (limite.isNever())
+        return false;
+
+    // Extrémités de la trajectoire.
+    double t = limite.time();
+    Coord<double> fin = mPosition.addMul(mVitesse, t) + gravity * t * t / 2.0;
+    min = Coord<double>(std::min(mPosition.x, fin.x), std::min(mPosition.y, fin.y));
+    max = Coord<double>(std::max(mPosition.x, fin.x), std::max(mPosition.y, fin.y));
+
+    // Sommet de la parabole selon chaque axe, s'il est atteint avant la limite.
+    if (gravity.x != 0.0)
     {
-        tmp = Solveur::fstQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y - (mArea.y + 1) * sizeArea);
-        if (tmp < result)
-            result = tmp;
-        tmp = Solveur::sndQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y - mArea.y * sizeArea);
+        double sommet = -mVitesse.x / gravity.x;
+        if (sommet > 0.0 && sommet < t)
+        {
+            double x = mPosition.x + mVitesse.x * sommet + gravity.x * sommet * sommet / 2.0;
+            min.x = std::min(min.x, x);
+            max.x = std::max(max.x, x);
+        }
     }
-    else if (gravity.y > 0.0)
+    if (gravity.y != 0.0)
     {
-        tmp = Solveur::sndQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y - (mArea.y + 1) * sizeArea);
-        if (tmp < result)
-            result = tmp;
-        tmp = Solveur::fstQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y - mArea.y * sizeArea);
+        double sommet = -mVitesse.y / gravity.y;
+        if (sommet > 0.0 && sommet < t)
+        {
+            double y = mPosition.y + mVitesse.y * sommet + gravity.y * sommet * sommet / 2.0;
+            min.y = std::min(min.y, y);
+            max.y = std::max(max.y, y);
+        }
     }
-    // Choix du plus proche temps.
-    if (tmp < result)
-        result = tmp;
 
-    return result;
+    min -= Coord<double>(mRayon);
+    max += Coord<double>(mRayon);
+    return true;
 }
 
 
-// Effectue la collision avec le mobile.
-void Boule::doCollision(Mobile* mobile, State& state)
-{
-    mobile->doCollision(this, state);
-}
-
 // Collision avec une boule.
 void Boule::doCollision(Boule* boule, State& state)
 {
@@ -267,9 +227,9 @@ void Boule::doCollision(Boule* boule, State& state)
         // Met à jour l'instant de la dernière collision.
         mOldFree = mLastFree;
         mLastFree.first = mPosition;
-        mLastFree.second = state.now;
+        mLastFree.second = state.instant();
         boule->mLastFree.first = boule->mPosition;
-        boule->mLastFree.second = state.now;
+        boule->mLastFree.second = state.instant();
 
         dPosition /= dPosition.length();
 
@@ -286,13 +246,11 @@ void Boule::doCollision(Boule* boule, State& state)
         this->updateRefresh(state);
         boule->updateRefresh(state);
     }
-    // Erreur : les mobiles s'éloignent !
+    // Contact rasant (les boules ne se rapprochent pas, à la précision des calculs près) : rien n'est changé.
+    // Les trajectoires étant inchangées et leur mouvement relatif rectiligne, les autres collisions prévues
+    // restent valables et les boules ne peuvent plus se rencontrer : aucune mise à jour n'est nécessaire.
     else
-    {
-        std::cerr << "rejected collision (balls) : " << *this << " ; " << *boule << std::endl;
-        state.toRefresh.insert(this);
-        state.toRefresh.insert(boule);
-    }
+        ++state.countDegeneres.rasantes;
 
     // Changements de populations issus du contact entre les boules (réactions).
     for (auto& reaction : state.config.configReactions())
@@ -303,7 +261,7 @@ void Boule::doCollision(Boule* boule, State& state)
             if (reaction.mType == ConfigReaction::proba)
             {
                 std::bernoulli_distribution distrib(reaction.mSeuil);
-                if (!distrib(Solveur::generateur))
+                if (!distrib(state.generateur))
                     break;
             }
 
@@ -336,7 +294,7 @@ void Boule::doCollision(Piston* piston, State& state)
         // Met à jour l'instant de la dernière collision.
         mOldFree = mLastFree;
         mLastFree.first = mPosition;
-        mLastFree.second = state.now;
+        mLastFree.second = state.instant();
 
         // Changement des vitesses selon les masses.
         mVitesse.y = (vitesse1 * (mMasse - piston->mMasse) + vitesse2 * 2.0 * piston->mMasse) / (mMasse + piston->mMasse);
@@ -345,13 +303,9 @@ void Boule::doCollision(Piston* piston, State& state)
         this->updateRefresh(state);
         piston->updateRefresh(state);
     }
-    // Erreur : les mobiles s'éloignent !
+    // Contact rasant : rien n'est changé (même gravité pour les deux mobiles, voir la collision entre boules).
     else
-    {
-        std::cerr << "rejected collision (piston) : " << *this << " ; " << *piston << std::endl;
-        state.toRefresh.insert(this);
-        state.toRefresh.insert(piston);
-    }
+        ++state.countDegeneres.rasantes;
 }
 
 // Collision avec un sommet.
@@ -366,7 +320,7 @@ void Boule::doCollision(const Coord<double>& sommet, State& state)
         // Met à jour l'instant de la dernière collision.
         mOldFree = mLastFree;
         mLastFree.first = mPosition;
-        mLastFree.second = state.now;
+        mLastFree.second = state.instant();
 
         // Changement de vitesse selon l'axe [centre boule -- choc].
         dPosition /= dPosition.length();
@@ -375,11 +329,13 @@ void Boule::doCollision(const Coord<double>& sommet, State& state)
 
         this->updateRefresh(state);
     }
-    // Erreur : la boule s'éloigne du sommet !
+    // Contact rasant : rien n'est changé. Sans gravité, la boule ne peut plus rencontrer le sommet ; sinon la gravité
+    // peut l'y ramener, et ses collisions sont recalculées.
     else
     {
-        std::cerr << "rejected collision (vertex) : " << *this << std::endl;
-        state.toRefresh.insert(this);
+        ++state.countDegeneres.rasantes;
+        if (state.gravite != Gravite::_nulle)
+            state.toRefresh.insert(this);
     }
 }
 
@@ -394,34 +350,72 @@ void Boule::doCollision(const Segment& segment, State& state)
         // Met à jour l'instant de la dernière collision.
         mOldFree = mLastFree;
         mLastFree.first = mPosition;
-        mLastFree.second = state.now;
+        mLastFree.second = state.instant();
 
         // Changement de vitesse selon l'axe orthogonal au segment.
-        vect /= vect.length();
-        mVitesse = vect * vect.scalar(mVitesse)
-                + Coord<double>(vect.y, -vect.x) * vect.det(mVitesse);
+        const Coord<double>& unitaire = segment.unitaire();
+        mVitesse = unitaire * unitaire.scalar(mVitesse)
+                + segment.normale() * unitaire.det(mVitesse);
         this->updateRefresh(state);
     }
-    // Erreur : la boule s'éloigne du segment !
+    // Contact rasant : rien n'est changé. Sans gravité, la boule ne peut plus rencontrer le segment ; sinon la gravité
+    // peut l'y ramener, et ses collisions sont recalculées.
     else
     {
-        std::cerr << "rejected collision (segment) : " << *this << std::endl;
-        state.toRefresh.insert(this);
+        ++state.countDegeneres.rasantes;
+        if (state.gravite != Gravite::_nulle)
+            state.toRefresh.insert(this);
     }
 }
 
 // Effectue un changement de zone.
 void Boule::changeArea(State& state)
 {
+    // Avec les listes de voisins, ou si la trajectoire vient de changer, toutes les collisions sont recalculées.
+    if (this->limitedSearch(state) || state.toRefresh.count(this))
+    {
+        this->detachArea(state);
+        this->setArea(state);
+        return;
+    }
+
+    // Sinon, les prévisions restent valables : seuls les mobiles nouvellement à portée sont étudiés, ainsi que
+    // les obstacles, cherchés jusqu'au prochain changement de zone.
+    Coord<double> min;
+    Coord<double> max;
+    this->region(state, min, max);
+
     this->detachArea(state);
-    this->setArea(state);
+    this->nextArea(state);
+    this->attachArea(state);
+    this->extendCollisions(min, max, state);
 }
 
 
 // Recalcule la zone et met à jour la table des zones.
 void Boule::setArea(State& state)
 {
-    double sizeArea = state.sizeArea;
+    // Avec les listes de voisins, la zone est centrée sur la position actuelle.
+    if (state.recherche == State::_voisins)
+    {
+        mReference = mPosition;
+        mArea = state.grilles[mLevel].area(mPosition);
+        this->attachArea(state);
+        this->updateVoisins(state);
+        this->updateRefresh(state);
+        return;
+    }
+
+    // Mise à jour de la table.
+    this->nextArea(state);
+    this->attachArea(state);
+    this->updateRefresh(state);
+}
+
+// Calcule la case dans laquelle entre la boule (elle est sur un bord de sa case actuelle).
+void Boule::nextArea(const State& state)
+{
+    double sizeArea = state.grilles[mLevel].sizeArea();
     bool x = (std::fabs(std::round(mPosition.x / sizeArea) - mPosition.x / sizeArea) <= std::fabs(std::round(mPosition.y / sizeArea) - mPosition.y / sizeArea));
 
     // Calcul des zones
@@ -439,57 +433,414 @@ void Boule::setArea(State& state)
         else
             mArea.y = std::floor(mPosition.y / sizeArea - 0.5);
     }
+}
 
-    // Mise à jour de la table.
-    mMapIt = state.mapMobiles[mArea.y].boules().insert(mArea.x, this);
-    this->updateRefresh(state);
+
+// Replace la boule dans la case de sa position actuelle, après reconstruction des grilles.
+void Boule::resetArea(State& state)
+{
+    // Les grilles viennent d'être reconstruites : la boule n'est plus répertoriée.
+    mVoisins.clear();
+    mReference = mPosition;
+    mArea = state.grilles[mLevel].area(mPosition);
+    this->attachArea(state);
+}
+
+// Reconstruit la liste des voisins (boules dont la peau recoupe celle-ci), et celles des voisins concernés.
+void Boule::updateVoisins(State& state)
+{
+    // Retire la boule des listes de ses anciens voisins.
+    for (auto& voisin : mVoisins)
+    {
+        auto it = std::find(voisin->mVoisins.begin(), voisin->mVoisins.end(), this);
+        *it = voisin->mVoisins.back();
+        voisin->mVoisins.pop_back();
+    }
+    mVoisins.clear();
+
+    // Parcourt les cases de chaque grille pouvant contenir une boule dont la peau recoupe celle-ci.
+    double peau = mRayon + state.grilles[mLevel].peau();
+    for (auto& grille : state.grilles)
+    {
+        double portee = peau + grille.rayon() + grille.peau();
+        Coord<int> debut = grille.area(Coord<double>(mReference.x - portee, mReference.y - portee));
+        Coord<int> fin = grille.area(Coord<double>(mReference.x + portee, mReference.y + portee));
+
+        for (int j = debut.y ; j <= fin.y ; ++j)
+        {
+            for (int i = debut.x ; i <= fin.x ; ++i)
+            {
+                const Grille::Cell* cell = grille.find(Coord<int>(i, j));
+                if (!cell)
+                    continue;
+
+                for (auto& boule : cell->mBoules)
+                {
+                    if (boule == this)
+                        continue;
+
+                    double distance = peau + boule->mRayon + grille.peau();
+                    if (std::fabs(boule->mReference.x - mReference.x) <= distance && std::fabs(boule->mReference.y - mReference.y) <= distance)
+                    {
+                        mVoisins.push_back(boule);
+                        boule->mVoisins.push_back(this);
+                    }
+                }
+            }
+        }
+    }
 }
 
 
+// Amène la boule à l'instant présent, nouvelle origine des temps, et y recopie sa trajectoire.
+void Boule::recale(State& state)
+{
+    // La clé de la ligne est décalée de la même quantité pour toutes les boules (ce qui préserve l'ordre de la ligne).
+    mCleLigne += state.config.gravity().y * state.now.time();
+    Mobile::recale(state);
+    state.particules.setTrajectoire(mRang, mPosition, mVitesse, mTime);
+}
+
 // Cherche des collisions avec des mobiles.
 void Boule::updateCollisionsMobiles(State& state)
 {
-    // Ensemble des segments trouvés dans les zones voisines.
-    std::set<Segment> segments;
+    // La trajectoire vient d'être modifiée (toute recherche complète suit un changement de vitesse).
+    state.particules.setTrajectoire(mRang, mPosition, mVitesse, mTime);
+    this->updateLigne(state);
+
+    // Rectangle parcouru par le centre de la boule tant qu'elle reste dans sa zone.
+    Coord<double> min;
+    Coord<double> max;
+    this->region(state, min, max);
+
+    // Vérifie les boules à portée.
+    this->parcourtBoules(min, max, state, [&](Boule* boule) {this->addLot(boule, state);});
+    this->testeLot(state);
 
-    // Vérifie les mobiles des zones voisines.
-    for (int j = mArea.y - 1 ; j <= mArea.y + 1 ; ++j)
+    this->testePistonsObstacles(min, max, state);
+}
+
+// Calcule les collisions avec les boules déjà placées (d'indice inférieur), toutes à l'instant de leur création :
+// le lot est le même que celui de la recherche faite juste après avoir placé la boule.
+void Boule::chercheLot(const State& state, std::vector<Boule*>& lot, Quadratiques& equations, Premieres& premieres) const
+{
+    Coord<double> min;
+    Coord<double> max;
+    this->region(state, min, max);
+
+    lot.clear();
+    this->parcourtBoules(min, max, state, [&](Boule* boule) {
+        if (boule->id() < this->id())
+            lot.push_back(boule);
+    });
+
+    // Horizon tel que le fixera Mobile::updateHorizon.
+    Time horizon = this->limitedSearch(state) ? state.now + this->newArea(state) : Time();
+    premieres.mEtudes = lot.size();
+    premieres.mEcartees = this->prepareLot(lot, horizon - state.now, equations);
+
+    equations.fstApproches();
+
+    premieres.mRacines.clear();
+    for (unsigned int i = 0 ; i < lot.size() ; ++i)
+        premieres.mRacines.push_back(std::make_pair(lot[i], equations.racine(i)));
+}
+
+// Cherche les premières collisions de la boule, dans le même ordre que Mobile::updateCollisions.
+void Boule::premieresCollisions(const Premieres& premieres, State& state)
+{
+    this->synchronize(state);
+    this->updateHorizon(state);
+    state.particules.setTrajectoire(mRang, mPosition, mVitesse, mTime);
+    this->updateLigne(state);
+
+    Coord<double> min;
+    Coord<double> max;
+    this->region(state, min, max);
+
+    state.countEtudes.total += premieres.mEtudes;
+    state.countEtudes.mobiles += premieres.mEtudes;
+    state.countEtudes.ecartees += premieres.mEcartees;
+    for (auto& racine : premieres.mRacines)
+        this->testeCollision(racine.first, state.now + racine.second, state);
+
+    this->testePistonsObstacles(min, max, state);
+}
+
+// Appelle la fonction sur chaque boule à portée de la région.
+template <typename Fonction>
+void Boule::parcourtBoules(const Coord<double>& min, const Coord<double>& max, const State& state, Fonction fonction) const
+{
+    // Boules voisines.
+    if (state.recherche == State::_voisins)
     {
-        //auto& mapj = state.mapMobiles[j];
+        for (auto& boule : mVoisins)
+            fonction(boule);
+        return;
+    }
 
-        for (int i = mArea.x - 1 ; i <= mArea.x + 1 ; ++i)
+    // Boules de chaque grille, dans les cases à portée (les zones voisines pour la grille de la boule).
+    for (auto& grille : state.grilles)
+    {
+        double portee = mRayon + grille.rayon();
+        Coord<int> debut = grille.area(Coord<double>(min.x - portee, min.y - portee));
+        Coord<int> fin = grille.area(Coord<double>(max.x + portee, max.y + portee));
+
+        for (int j = debut.y ; j <= fin.y ; ++j)
         {
-            // Vérifie les boules.
-            for (auto& boule : state.mapMobiles[j].boules().values(i))
-                if (boule != this)
-                    this->testeCollision(boule, state);
-
-            // Vérifie les sommets.
-            for (auto& sommet : state.mapMobiles[j].sommets().values(i))
-                this->testeCollision(Collision(this, sommet), state);
-
-            // Ajoute les segments à l'ensemble à traiter (un segment peut être sur plusieurs zones).
-            for (auto& segment : state.mapMobiles[j].segments().value(i))
-                segments.insert(segment);
+            for (int i = debut.x ; i <= fin.x ; ++i)
+            {
+                const Grille::Cell* cell = grille.find(Coord<int>(i, j));
+                if (!cell)
+                    continue;
+
+                for (auto& boule : cell->mBoules)
+                    fonction(boule);
+            }
         }
+    }
+}
+
+// Cherche les collisions avec les pistons et les obstacles à portée de la région.
+void Boule::testePistonsObstacles(const Coord<double>& min, const Coord<double>& max, State& state)
+{
+    // Vérifie les pistons (répertoriés dans la grille de référence).
+    const Grille& reference = state.grilles.front();
+    int debut = std::floor((min.y - mRayon) / reference.sizeArea());
+    int fin = std::floor((max.y + mRayon) / reference.sizeArea());
+    for (int j = debut ; j <= fin ; ++j)
+    {
+        const std::vector<Piston*>* pistons = reference.findPistons(j);
+        if (pistons)
+            for (auto& piston : *pistons)
+                this->testeCollision(piston, state);
+    }
+
+    // Vérifie les obstacles (la case de la boule répertorie ceux des zones voisines, sans doublon).
+    for (auto& sommet : mCell->mSommets)
+        this->testeCollision(Collision(Collision::_sommet, this->id(), sommet), state);
+    for (auto& segment : mCell->mSegments)
+        this->testeCollision(Collision(Collision::_segment, this->id(), segment), state);
+}
+
+// Cherche les collisions avec les mobiles nouvellement à portée après un changement de case (ceux à portée
+// de l'ancienne région "min, max" ont déjà été étudiés), et avec les obstacles de la nouvelle case.
+void Boule::extendCollisions(const Coord<double>& min, const Coord<double>& max, State& state)
+{
+    // Prochain changement de zone.
+    this->updateHorizon(state);
+
+    Coord<double> newMin;
+    Coord<double> newMax;
+    this->region(state, newMin, newMax);
+
+    // Vérifie les boules des cases nouvellement à portée, dans chaque grille.
+    for (auto& grille : state.grilles)
+    {
+        double portee = mRayon + grille.rayon();
+        Coord<int> exclusDebut = grille.area(Coord<double>(min.x - portee, min.y - portee));
+        Coord<int> exclusFin = grille.area(Coord<double>(max.x + portee, max.y + portee));
+        Coord<int> debut = grille.area(Coord<double>(newMin.x - portee, newMin.y - portee));
+        Coord<int> fin = grille.area(Coord<double>(newMax.x + portee, newMax.y + portee));
+
+        for (int j = debut.y ; j <= fin.y ; ++j)
+        {
+            bool exclusY = (j >= exclusDebut.y && j <= exclusFin.y);
+            for (int i = debut.x ; i <= fin.x ; ++i)
+            {
+                if (exclusY && i >= exclusDebut.x && i <= exclusFin.x)
+                    continue;
+
+                const Grille::Cell* cell = grille.find(Coord<int>(i, j));
+                if (!cell)
+                    continue;
+
+                for (auto& boule : cell->mBoules)
+                    this->addLot(boule, state);
+            }
+        }
+    }
+    this->testeLot(state);
+
+    // Vérifie les pistons des lignes nouvellement à portée.
+    const Grille& reference = state.grilles.front();
+    int exclusDebut = std::floor((min.y - mRayon) / reference.sizeArea());
+    int exclusFin = std::floor((max.y + mRayon) / reference.sizeArea());
+    int debut = std::floor((newMin.y - mRayon) / reference.sizeArea());
+    int fin = std::floor((newMax.y + mRayon) / reference.sizeArea());
+    for (int j = debut ; j <= fin ; ++j)
+    {
+        if (j >= exclusDebut && j <= exclusFin)
+            continue;
+
+        const std::vector<Piston*>* pistons = reference.findPistons(j);
+        if (pistons)
+            for (auto& piston : *pistons)
+                this->testeCollision(piston, state);
+    }
+
+    // Vérifie les obstacles de la case, sauf ceux dont la collision est déjà prévue : les autres n'ont été
+    // cherchés que jusqu'au changement de zone.
+    for (auto& sommet : mCell->mSommets)
+    {
+        Collision collision(Collision::_sommet, this->id(), sommet);
+        if (!this->isCandidate(collision))
+            this->testeCollision(collision, state);
+    }
+    for (auto& segment : mCell->mSegments)
+    {
+        Collision collision(Collision::_segment, this->id(), segment);
+        if (!this->isCandidate(collision))
+            this->testeCollision(collision, state);
+    }
+}
+
+// Ajoute la boule au lot à étudier, sauf s'il s'agit de celle-ci ou si la collision est déjà prévue.
+void Boule::addLot(Boule* boule, State& state) const
+{
+    if (boule != this && !this->isCandidate(Collision(Collision::_mobiles, this->id(), boule->id())))
+        state.lot.push_back(boule);
+}
+
+// Teste les collisions avec les boules du lot (les équations sont résolues ensemble), puis vide le lot.
+void Boule::testeLot(State& state)
+{
+    // Avec un horizon borné, les boules qui ne peuvent pas être atteintes d'ici là sont écartées sans calcul.
+    Time limite = this->horizon() - state.now;
+    state.countEtudes.total += state.lot.size();
+    state.countEtudes.mobiles += state.lot.size();
+
+    // Les boules du lot sont amenées à l'instant présent.
+    for (auto& boule : state.lot)
+        boule->synchronize(state);
+    Quadratiques& equations = state.quadratiques;
+    state.countEtudes.ecartees += this->prepareLot(state.lot, limite, equations);
+
+    equations.fstApproches();
+
+    for (unsigned int i = 0 ; i < state.lot.size() ; ++i)
+        this->testeCollision(state.lot[i], state.now + equations.racine(i), state);
+    state.lot.clear();
+}
+
+// Ecarte du lot les boules hors d'atteinte d'ici la limite, et range les équations des autres.
+unsigned int Boule::prepareLot(std::vector<Boule*>& lot, const Time& limite, Quadratiques& equations) const
+{
+    equations.clear();
+    unsigned int count = 0;
+    for (auto& boule : lot)
+    {
+        if (!limite.isNever() && this->ecarte(boule, limite.time()))
+            continue;
 
-        // Vérifie les pistons.
-        for (auto& piston : state.mapMobiles[j].pistons())
-            this->testeCollision(piston, state);
+        double a, b, c;
+        this->equation(boule, a, b, c);
+        equations.add(a, b, c);
+        lot[count++] = boule;
     }
 
-    // Vérifie les segments listés.
-    for (auto& segment : segments)
-        this->testeCollision(Collision(this, segment), state);
+    unsigned int ecartees = lot.size() - count;
+    lot.resize(count);
+    return ecartees;
+}
 
-    // Vérifie un changement de zone.
-    this->testeCollision(Collision(this), state);
+// Indique si la boule ne peut pas toucher l'autre d'ici la limite : la gravité étant la même pour les deux,
+// leur différence de position est rectiligne, et le rectangle qu'elle balaie reste loin de l'origine.
+bool Boule::ecarte(const Boule* boule, double limite) const
+{
+    Coord<double> debut = mPosition - boule->mPosition;
+    Coord<double> fin = debut.addMul(mVitesse - boule->mVitesse, limite);
+    double rayons = mRayon + boule->mRayon;
+
+    return std::min(debut.x, fin.x) > rayons || std::max(debut.x, fin.x) < -rayons
+        || std::min(debut.y, fin.y) > rayons || std::max(debut.y, fin.y) < -rayons;
+}
+
+// Indique si les collisions ne sont cherchées que jusqu'au prochain changement de zone.
+bool Boule::limitedSearch(const State& state) const
+{
+    return state.recherche == State::_voisins;
 }
 
-// Enlève la boule de la table des zones.
+// Rectangle dans lequel reste le centre de la boule jusqu'au prochain changement de zone.
+void Boule::region(const State& state, Coord<double>& min, Coord<double>& max) const
+{
+    const Grille& grille = state.grilles[mLevel];
+    if (state.recherche == State::_voisins)
+    {
+        min = Coord<double>(mReference.x - grille.peau(), mReference.y - grille.peau());
+        max = Coord<double>(mReference.x + grille.peau(), mReference.y + grille.peau());
+    }
+    else
+    {
+        min = Coord<double>(mArea.x * grille.sizeArea(), mArea.y * grille.sizeArea());
+        max = Coord<double>((mArea.x + 1) * grille.sizeArea(), (mArea.y + 1) * grille.sizeArea());
+    }
+}
+
+// Ajoute la boule à la case de sa zone, et à sa ligne.
+void Boule::attachArea(State& state)
+{
+    Grille& grille = state.grilles[mLevel];
+    mCell = &grille.cell(mArea);
+    mCellIndex = mCell->mBoules.size();
+    mCell->mBoules.push_back(this);
+
+    // Les lignes ne servent qu'à la recherche des pistons.
+    if (state.pistons.empty())
+        return;
+    mLigne = &grille.boules(mArea.y);
+    mCleLigne = this->vitesseOrigine(state.config.gravity());
+    this->insertLigne();
+}
+
+// Enlève la boule de la table des zones (la dernière boule de la case prend sa place).
 void Boule::detachArea(State& state)
 {
-    state.mapMobiles[mArea.y].boules().erase(mMapIt);
+    Boule* last = mCell->mBoules.back();
+    mCell->mBoules[mCellIndex] = last;
+    last->mCellIndex = mCellIndex;
+    mCell->mBoules.pop_back();
+
+    if (mLigne)
+        this->eraseLigne();
+
+    mCell = nullptr;
+    mLigne = nullptr;
+    state.grilles[mLevel].release(mArea);
+}
+
+// Replace la boule dans sa ligne après un changement de trajectoire.
+void Boule::updateLigne(State& state)
+{
+    if (!mLigne)
+        return;
+
+    double cle = this->vitesseOrigine(state.config.gravity());
+    if (cle == mCleLigne)
+        return;
+
+    this->eraseLigne();
+    mCleLigne = cle;
+    this->insertLigne();
+}
+
+// Range la boule dans sa ligne, triée par vitesse verticale ramenée à l'origine des temps.
+void Boule::insertLigne()
+{
+    auto it = std::upper_bound(mLigne->begin(), mLigne->end(), mCleLigne,
+                               [](double cle, const Boule* boule) {return cle < boule->mCleLigne;});
+    mLigne->insert(it, this);
+}
+
+// Retire la boule de sa ligne (cherchée parmi les boules de même clé).
+void Boule::eraseLigne()
+{
+    auto it = std::lower_bound(mLigne->begin(), mLigne->end(), mCleLigne,
+                               [](const Boule* boule, double cle) {return boule->mCleLigne < cle;});
+    while (*it != this)
+        ++it;
+    mLigne->erase(it);
 }
 
 
@@ -503,7 +854,7 @@ void Boule::swap(unsigned int population, State& state, bool eraseEvent)
     mColor = state.populations[population].color();
 
     // Met à jour les événements (mutations).
-    if (eraseEvent && mEventIt != state.events.end())
-        state.events.erase(mEventIt);
+    if (eraseEvent && mEventHandle != EventQueue::none)
+        state.events.erase(mEventHandle);
     this->setPopulation(population, state);
 }
@@ -20,17 +20,26 @@
 #define BOULE_HPP
 
 #include "mobile.hpp"
+#include "grille.hpp"
+
+class Quadratiques;
 
 // Mobile décrivant une particule en forme de boule.
 class Boule : public Mobile
 {
 public:
+    // Collisions avec les boules déjà placées, calculées d'avance pour la recherche initiale : boules (d'indice
+    // inférieur) et instants relatifs, nombre de boules étudiées et nombre d'écartées sans calcul.
+    struct Premieres
+    {
+        std::vector<std::pair<Boule*, double> > mRacines;
+        unsigned int mEtudes;
+        unsigned int mEcartees;
+    };
+
     // Constructeur.
     Boule(const Coord<double>& position, const Coord<double>& vitesse, const QColor& color, double masse, double rayon, State& state);
 
-    // Avance le mobile jusqu'à l'instant indiqué (sans tenir compte des autres mobiles).
-    virtual void avance(const Time& time, const Coord<double>& gravity);
-
     // Effectue une mutation pour cette boule.
     void changePopulation(State& state);
     // Définit la population de cette boule et prépare la prochaine mutation.
@@ -40,52 +49,114 @@ public:
     inline Coord<double> freeRide() const;
     inline Time freeTime() const;
     inline bool validFree() const;
-    inline Coord<double> fromOrigin() const;
+    inline const Coord<double>& origine() const;
     inline double rayon() const;
     inline Coord<int> area() const;
+    inline unsigned int rang() const;
     inline unsigned int population() const;
+    // Vitesse verticale ramenée à l'origine des temps, selon laquelle la boule est rangée dans sa ligne.
+    inline double cleLigne() const;
 
-    // Calcule l'instant de la prochaine collision avec le mobile.
-    Time collision(const Mobile* mobile) const;
-    Time collision(const Boule* boule) const;
-    Time collision(const Piston* piston) const;
+    // Calcule l'instant de la prochaine collision avec le mobile (noyaux des paires, appelés directement par Paires).
+    inline Time collision(const Boule* boule) const;
+    inline Time collision(const Piston* piston) const;
     // Calcule l'instant de la prochaine collision avec l'obstacle.
-    Time collision(const Coord<double>& sommet, const Coord<double>& gravity) const;
+    Time collision(const Coord<double>& sommet, const Coord<double>& gravity, const Time& limite) const;
     Time collision(const Segment& segment, const Coord<double>& gravity) const;
     // Calcule l'instant du prochain changement de zone.
-    Time newArea(double sizeArea, const Coord<double>& gravity) const;
+    Time newArea(const State& state) const;
+    // Rectangle balayé par la boule (rayon compris) d'ici la limite.
+    bool balayage(const Coord<double>& gravity, const Time& limite, Coord<double>& min, Coord<double>& max) const;
 
     // Effectue la collision avec le mobile.
-    virtual void doCollision(Mobile* mobile, State& state);
-    virtual void doCollision(Boule* boule, State& state);
-    virtual void doCollision(Piston* piston, State& state);
+    void doCollision(Boule* boule, State& state);
+    void doCollision(Piston* piston, State& state);
     virtual void doCollision(const Coord<double>& sommet, State& state);
     virtual void doCollision(const Segment& segment, State& state);
     void changeArea(State& state);
+    // Amène la boule à l'instant présent, nouvelle origine des temps, et y recopie sa trajectoire.
+    void recale(State& state);
 
     // Recalcule la zone et met à jour la table des zones.
     void setArea(State& state);
+    // Replace la boule dans la case de sa position actuelle, après reconstruction des grilles.
+    void resetArea(State& state);
+    // Reconstruit la liste des voisins (boules dont la peau recoupe celle-ci), et celles des voisins concernés.
+    void updateVoisins(State& state);
+
+    // Calcule les collisions avec les boules déjà placées, toutes à l'instant de leur création. Rien d'autre que
+    // le lot, les équations et le résultat n'est modifié : les boules peuvent être traitées en parallèle.
+    void chercheLot(const State& state, std::vector<Boule*>& lot, Quadratiques& equations, Premieres& premieres) const;
+    // Cherche les premières collisions de la boule, celles avec les boules déjà placées étant calculées d'avance.
+    void premieresCollisions(const Premieres& premieres, State& state);
 
 private:
     // Cherche des collisions avec des mobiles.
     void updateCollisionsMobiles(State& state);
+    // Cherche les collisions avec les mobiles nouvellement à portée après un changement de case (ceux à portée
+    // de l'ancienne région ont déjà été étudiés), et avec les obstacles de la nouvelle case.
+    void extendCollisions(const Coord<double>& min, const Coord<double>& max, State& state);
+    // Appelle la fonction sur chaque boule à portée de la région (voisins, ou cases de chaque grille).
+    template <typename Fonction>
+    void parcourtBoules(const Coord<double>& min, const Coord<double>& max, const State& state, Fonction fonction) const;
+    // Cherche les collisions avec les pistons et les obstacles à portée de la région.
+    void testePistonsObstacles(const Coord<double>& min, const Coord<double>& max, State& state);
+    // Ajoute la boule au lot à étudier (sauf si la collision est déjà prévue).
+    void addLot(Boule* boule, State& state) const;
+    // Teste les collisions avec les boules du lot, puis vide le lot.
+    void testeLot(State& state);
+    // Ecarte du lot les boules hors d'atteinte d'ici la limite, et range les équations des autres
+    // (renvoie le nombre de boules écartées).
+    unsigned int prepareLot(std::vector<Boule*>& lot, const Time& limite, Quadratiques& equations) const;
+    // Indique si la boule ne peut pas toucher l'autre d'ici la limite (test des rectangles balayés).
+    bool ecarte(const Boule* boule, double limite) const;
+    // Coefficients de l'équation donnant les instants de contact avec l'autre boule.
+    inline void equation(const Boule* boule, double& a, double& b, double& c) const;
+    // Indique si les collisions ne sont cherchées que jusqu'au prochain changement de zone.
+    bool limitedSearch(const State& state) const;
+    // Calcule la case dans laquelle entre la boule.
+    void nextArea(const State& state);
+    // Instant de sortie de la région, selon la politique de gravité.
+    template <typename Politique>
+    Time sortieZone(Politique politique, const State& state) const;
+    // Rectangle dans lequel reste le centre de la boule jusqu'au prochain changement de zone.
+    void region(const State& state, Coord<double>& min, Coord<double>& max) const;
+    // Ajoute la boule à la case de sa zone.
+    void attachArea(State& state);
     // Enlève la boule de la table des zones.
     void detachArea(State& state);
+    // Replace la boule dans sa ligne après un changement de trajectoire.
+    void updateLigne(State& state);
+    // Range la boule dans sa ligne, triée par vitesse verticale ramenée à l'origine des temps, ou l'en retire.
+    void insertLigne();
+    void eraseLigne();
 
     // Change la boule de population.
     void swap(unsigned int population, State& state, bool eraseEvent);
 
-    // Propriétés géométriques.
+    // Propriétés géométriques (les derniers libres parcours sont datés depuis le début de la simulation).
     Coord<double> mOrigine;
     std::pair<Coord<double>, Time> mOldFree;
     std::pair<Coord<double>, Time> mLastFree;
     double mRayon;
+    // Grille de la classe de rayons de la boule, et zone dans celle-ci.
+    unsigned int mLevel;
     Coord<int> mArea;
-    QMultiMap<int, Boule*>::iterator mMapIt;
+    // Case de la zone et position de la boule dans celle-ci, ligne de la zone (en présence de pistons) et clé de
+    // la boule dans celle-ci.
+    Grille::Cell* mCell;
+    unsigned int mCellIndex;
+    std::vector<Boule*>* mLigne;
+    double mCleLigne;
+    // Position de construction de la liste des voisins, et boules dont la peau recoupe celle-ci.
+    Coord<double> mReference;
+    std::vector<Boule*> mVoisins;
+    // Rang de la boule dans les tableaux des particules (et dans la table des boules de l'état).
+    unsigned int mRang;
 
     // Population contenant la boule.
     unsigned int mPopulation;
-    std::multimap<Time, std::shared_ptr<Event> >::iterator mEventIt;
+    EventQueue::Handle mEventHandle;
 };
 
 // Accesseurs.
@@ -95,13 +166,41 @@ inline Time Boule::freeTime() const
     {return mLastFree.second - mOldFree.second;}
 inline bool Boule::validFree() const
     {return !mOldFree.second.isNever();}
-inline Coord<double> Boule::fromOrigin() const
-    {return mPosition - mOrigine;}
+inline const Coord<double>& Boule::origine() const
+    {return mOrigine;}
 inline double Boule::rayon() const
     {return mRayon;}
 inline Coord<int> Boule::area() const
     {return mArea;}
+inline unsigned int Boule::rang() const
+    {return mRang;}
 inline unsigned int Boule::population() const
     {return mPopulation;}
+inline double Boule::cleLigne() const
+    {return mCleLigne;}
+
+// Calcule l'instant de la prochaine collision avec la boule.
+inline Time Boule::collision(const Boule* boule) const
+{
+    // Résolution d'une équation du second degré (seul un rapprochement donne une collision).
+    double a, b, c;
+    this->equation(boule, a, b, c);
+    return Solveur::fstApproche(a, b, c);
+}
+
+// Coefficients de l'équation du second degré donnant les instants de contact avec l'autre boule.
+inline void Boule::equation(const Boule* boule, double& a, double& b, double& c) const
+{
+    // Différence de vitesse et position.
+    Coord<double> dVitesse = mVitesse - boule->mVitesse;
+    Coord<double> dPosition = mPosition - boule->mPosition;
+
+    // Somme des rayons.
+    double rayons = mRayon + boule->mRayon;
+
+    a = dVitesse.squareLength();
+    b = 2.0 * dVitesse.scalar(dPosition);
+    c = dPosition.squareLength() - rayons * rayons;
+}
 
 #endif // BOULE_HPP
@@ -0,0 +1,228 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "calendar_scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Valeurs particulières.
+const Scheduler::Handle CalendarScheduler::none;
+const unsigned int CalendarScheduler::minBuckets;
+
+// Constructeur.
+CalendarScheduler::CalendarScheduler() :
+    mBuckets(minBuckets + 1),
+    mPositions(),
+    mNbBuckets(minBuckets),
+    mWidth(1.0),
+    mCount(0),
+    mLower(0.0),
+    mTop(none)
+{
+}
+
+
+// Vide la structure.
+void CalendarScheduler::clear()
+{
+    mBuckets.assign(minBuckets + 1, std::vector<Entry>());
+    mPositions.clear();
+    mNbBuckets = minBuckets;
+    mWidth = 1.0;
+    mCount = 0;
+    mLower = 0.0;
+    mTop = none;
+}
+
+
+// Ajoute un événement.
+void CalendarScheduler::push(Handle handle, const Time& time)
+{
+    if (handle >= mPositions.size())
+        mPositions.resize(handle + 1, Position{none, none});
+
+    Entry entry = {time.time(), 0, handle};
+
+    if (time.isNever())
+    {
+        this->insert(entry, true);
+        return;
+    }
+
+    // Le calendrier reprend au plus tôt à cette date.
+    if (entry.mTime < mLower)
+        mLower = entry.mTime;
+
+    entry.mWindow = std::floor(entry.mTime / mWidth);
+    this->insert(entry, false);
+    ++mCount;
+
+    // Mise à jour du prochain événement connu.
+    if (mTop != none && entry.mTime < mBuckets[mPositions[mTop].mBucket][mPositions[mTop].mIndex].mTime)
+        mTop = handle;
+
+    if (mCount > 2 * mNbBuckets)
+        this->resize(2 * mNbBuckets);
+}
+
+// Change la date d'un événement présent.
+void CalendarScheduler::update(Handle handle, const Time& time)
+{
+    this->remove(handle);
+    this->push(handle, time);
+}
+
+// Retire un événement présent.
+void CalendarScheduler::remove(Handle handle)
+{
+    Position position = mPositions[handle];
+    mPositions[handle] = Position{none, none};
+
+    // Le dernier élément du compartiment prend la place libérée.
+    std::vector<Entry>& bucket = mBuckets[position.mBucket];
+    if (position.mIndex + 1 != bucket.size())
+    {
+        bucket[position.mIndex] = bucket.back();
+        mPositions[bucket[position.mIndex].mHandle].mIndex = position.mIndex;
+    }
+    bucket.pop_back();
+
+    if (handle == mTop)
+        mTop = none;
+
+    if (position.mBucket != mNbBuckets)
+    {
+        --mCount;
+        if (mNbBuckets > minBuckets && 2 * mCount < mNbBuckets)
+            this->resize(mNbBuckets / 2);
+    }
+}
+
+
+// Indique si l'événement est présent.
+bool CalendarScheduler::contains(Handle handle) const
+{
+    return handle < mPositions.size() && mPositions[handle].mBucket != none;
+}
+
+// Nombre d'événements présents.
+unsigned int CalendarScheduler::size() const
+{
+    return mCount + mBuckets[mNbBuckets].size();
+}
+
+// Prochain événement.
+Scheduler::Handle CalendarScheduler::top()
+{
+    if (mTop != none)
+        return mTop;
+
+    // Seuls des événements n'ayant jamais lieu sont présents.
+    if (!mCount)
+        return mTop = mBuckets[mNbBuckets].front().mHandle;
+
+    // Parcours des compartiments sur une année à partir de la borne inférieure.
+    long long window = std::floor(mLower / mWidth);
+    unsigned int mask = mNbBuckets - 1;
+    for (unsigned int i = 0 ; i < mNbBuckets ; ++i, ++window)
+    {
+        const Entry* best = nullptr;
+        for (auto& entry : mBuckets[window & mask])
+            if (entry.mWindow == window && (!best || entry.mTime < best->mTime))
+                best = &entry;
+
+        if (best)
+        {
+            mLower = best->mTime;
+            return mTop = best->mHandle;
+        }
+    }
+
+    // Calendrier trop clairsemé : recherche directe du minimum.
+    const Entry* best = nullptr;
+    for (unsigned int i = 0 ; i < mNbBuckets ; ++i)
+        for (auto& entry : mBuckets[i])
+            if (!best || entry.mTime < best->mTime)
+                best = &entry;
+
+    mLower = best->mTime;
+    return mTop = best->mHandle;
+}
+
+
+// Ajoute un élément dans son compartiment.
+void CalendarScheduler::insert(const Entry& entry, bool never)
+{
+    unsigned int index = never ? mNbBuckets : (entry.mWindow & (mNbBuckets - 1));
+    mPositions[entry.mHandle] = Position{index, (unsigned int)mBuckets[index].size()};
+    mBuckets[index].push_back(entry);
+}
+
+// Redimensionne le calendrier.
+void CalendarScheduler::resize(unsigned int nbBuckets)
+{
+    mWidth = this->estimateWidth();
+
+    // Répartition des événements dans les nouveaux compartiments.
+    std::vector<std::vector<Entry> > buckets(nbBuckets + 1);
+    buckets[nbBuckets].swap(mBuckets[mNbBuckets]);
+    mBuckets.swap(buckets);
+    mNbBuckets = nbBuckets;
+
+    for (unsigned int i = 0 ; i + 1 < buckets.size() ; ++i)
+    {
+        for (auto& entry : buckets[i])
+        {
+            Entry copy = entry;
+            copy.mWindow = std::floor(copy.mTime / mWidth);
+            this->insert(copy, false);
+        }
+    }
+    for (unsigned int i = 0 ; i < mBuckets[mNbBuckets].size() ; ++i)
+        mPositions[mBuckets[mNbBuckets][i].mHandle] = Position{mNbBuckets, i};
+}
+
+// Estime une largeur de compartiment adaptée aux événements présents.
+double CalendarScheduler::estimateWidth() const
+{
+    // Echantillon régulier des dates des événements.
+    const unsigned int sampleSize = 64;
+    unsigned int step = std::max(1u, mCount / sampleSize);
+    std::vector<double> sample;
+
+    unsigned int k = 0;
+    for (unsigned int i = 0 ; i < mNbBuckets ; ++i)
+        for (auto& entry : mBuckets[i])
+            if (k++ % step == 0)
+                sample.push_back(entry.mTime);
+
+    if (sample.size() < 4)
+        return mWidth;
+
+    // Ecart moyen entre événements parmi les plus proches (la moitié de l'échantillon).
+    std::sort(sample.begin(), sample.end());
+    unsigned int half = sample.size() / 2;
+    double span = sample[half - 1] - sample[0];
+    double separation = span / (half - 1) * sample.size() / mCount;
+
+    // Largeur égale à environ trois fois l'écart moyen.
+    if (!(separation > 0.0) || !std::isfinite(separation))
+        return mWidth;
+    return 3.0 * separation;
+}
@@ -0,0 +1,86 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef CALENDAR_SCHEDULER_HPP
+#define CALENDAR_SCHEDULER_HPP
+
+#include <vector>
+#include "scheduler.hpp"
+
+// Ordonnanceur sous forme de calendrier (calendar queue) : les événements sont répartis dans des
+// compartiments correspondant à des intervalles de temps successifs, parcourus cycliquement.
+// Le nombre et la largeur des compartiments sont ajustés selon le nombre d'événements.
+class CalendarScheduler : public Scheduler
+{
+public:
+    // Constructeur.
+    CalendarScheduler();
+
+    void clear();
+
+    void push(Handle handle, const Time& time);
+    void update(Handle handle, const Time& time);
+    void remove(Handle handle);
+
+    bool contains(Handle handle) const;
+    unsigned int size() const;
+    Handle top();
+
+private:
+    // Elément d'un compartiment.
+    struct Entry
+    {
+        double mTime;
+        // Indice de l'intervalle de temps (le compartiment est cet indice modulo leur nombre).
+        long long mWindow;
+        Handle mHandle;
+    };
+
+    // Position d'un événement.
+    struct Position
+    {
+        unsigned int mBucket;
+        unsigned int mIndex;
+    };
+
+    // Valeurs particulières.
+    static const Handle none = -1;
+    static const unsigned int minBuckets = 2;
+
+    // Ajoute un élément dans son compartiment.
+    void insert(const Entry& entry, bool never);
+    // Redimensionne le calendrier.
+    void resize(unsigned int nbBuckets);
+    // Estime une largeur de compartiment adaptée aux événements présents.
+    double estimateWidth() const;
+
+    // Compartiments (le dernier contient les événements n'ayant jamais lieu).
+    std::vector<std::vector<Entry> > mBuckets;
+    std::vector<Position> mPositions;
+    unsigned int mNbBuckets;
+    double mWidth;
+
+    // Nombre d'événements datés.
+    unsigned int mCount;
+    // Borne inférieure des dates des événements présents.
+    double mLower;
+    // Prochain événement s'il est connu.
+    Handle mTop;
+};
+
+#endif // CALENDAR_SCHEDULER_HPP
@@ -18,9 +18,8 @@
 
 #include "collision.hpp"
 
-#include <cmath>
-#include "coord_io.tpl"
-#include "document.hpp"
+#include "paires.hpp"
+#include "state.hpp"
 
 
 // Affichage dans un flux standard.
@@ -30,142 +29,108 @@ std::ostream& operator<<(std::ostream& flux, const Collision& collision)
     if (collision.mType == Collision::_defaut)
         flux << "defaut";
     else if (collision.mType == Collision::_mobiles)
-        flux << *collision.mMobile1 << " ; " << *collision.mMobile2;
+        flux << collision.mIndex1 << " ; " << collision.mIndex2;
     else if (collision.mType == Collision::_sommet)
-        flux << *collision.mMobile1 << " : " << collision.mSommet;
+        flux << collision.mIndex1 << " : vertex " << collision.mIndex2;
     else if (collision.mType == Collision::_segment)
-        flux << *collision.mMobile1 << " -> " << collision.mSegment.vect();
+        flux << collision.mIndex1 << " -> segment " << collision.mIndex2;
     else if (collision.mType == Collision::_area)
-        flux << *collision.mMobile1 << " = area";
+        flux << collision.mIndex1 << " = area";
     flux << "}";
     return flux;
 }
 
 
-// Constructeurs.
-Collision::Collision() :
-    mType(_defaut)
-{
-}
-
-Collision::Collision(Mobile* mobile1, Mobile* mobile2) :
-    mMobile1(mobile1),
-    mMobile2(mobile2),
-    mType(_mobiles)
-{
-}
-
-Collision::Collision(Mobile* mobile, const Coord<double>& sommet) :
-    mMobile1(mobile),
-    mSommet(sommet),
-    mType(_sommet)
-{
-}
-
-Collision::Collision(Mobile* mobile, const Segment& segment) :
-    mMobile1(mobile),
-    mSegment(segment),
-    mType(_segment)
-{
-}
-
-Collision::Collision(Mobile* mobile) :
-    mMobile1(mobile),
-    mType(_area)
-{
-}
-
-
-// Effectue l'événement sur le simulateur en paramètre.
-bool Collision::perform(Simulateur& simulateur, bool&/* isDraw*/)
-{
-    return simulateur.performCollision(*this);
-}
-
-
-// Détache les deux mobiles (appelé si l'un d'eux change de trajectoire).
-void Collision::detach(const Mobile* mobile) const
+// Retire la collision des prévisions de l'autre mobile concerné.
+void Collision::detach(const Mobile* mobile, State& state) const
 {
     if (mType == _mobiles)
     {
-        if (mMobile1 == mobile)
-            mMobile2->detach(*this);
-        else if (mMobile2 == mobile)
-            mMobile1->detach(*this);
+        if (mobile->id() == mIndex1)
+            state.mobiles[mIndex2]->detach(*this, state);
+        else if (mobile->id() == mIndex2)
+            state.mobiles[mIndex1]->detach(*this, state);
     }
 }
 
 
 // Calcule l'instant de cette collision.
-Time Collision::time(State& state) const
+// Le calcul peut s'arrêter dès que l'instant dépasse l'horizon (la collision est alors ignorée).
+Time Collision::time(State& state, const Time& horizon) const
 {
     if (mType == _defaut)
         return Time();
 
-    ++state.countEtudes.first;
+    ++state.countEtudes.total;
+
+    // Les mobiles concernés sont amenés à l'instant présent.
+    Mobile* mobile1 = state.mobiles[mIndex1];
+    mobile1->synchronize(state);
+
+    // Ecarte sans calcul les obstacles hors du rectangle balayé par le mobile avant l'horizon.
+    if (this->isObstacle())
+    {
+        Coord<double> min;
+        Coord<double> max;
+        if (mobile1->balayage(state.config.gravity(), horizon - state.now, min, max)
+                && (mType == _sommet ? !state.sommets[mIndex2].inside(min, max)
+                                     : !state.segments[mIndex2].boxIntersect(min, max)))
+        {
+            ++state.countEtudes.ecartees;
+            return Time();
+        }
+    }
 
     // Utilise les méthodes implémentées par les classes de mobiles.
     Time time;
     if (mType == _mobiles)
     {
-        time = mMobile1->collision(mMobile2);
-        ++state.countEtudes.second;
+        Mobile* mobile2 = state.mobiles[mIndex2];
+        mobile2->synchronize(state);
+        time = PairesMobiles::collision(mobile1, mobile2);
+        ++state.countEtudes.mobiles;
     }
     else if (mType == _sommet)
-        time = mMobile1->collision(mSommet, state.config.gravity());
+        time = mobile1->collision(state.sommets[mIndex2], state.config.gravity(), horizon - state.now);
     else if (mType == _segment)
-        time = mMobile1->collision(mSegment, state.config.gravity());
+        time = mobile1->collision(state.segments[mIndex2], state.config.gravity());
     else if (mType == _area)
-        time = mMobile1->newArea(state.sizeArea, state.config.gravity());
+        time = mobile1->newArea(state);
 
-    // Empêche d'effectuer la même collision deux fois de suite (à cause d'erreurs d'arrondis).
-    // Cependant, la condition doit normalement être toujours fausse.
-    // TODO : valider la suppression des lignes suivantes.
-    if (mType != _area && (!mMobile1->checkLastCollision(*this, state.now + time)) && (mType != _mobiles || (!mMobile2->checkLastCollision(*this, state.now + time))))
+    // Empêche d'effectuer la même collision deux fois au même instant (contact prévu à nouveau à cause d'erreurs
+    // d'arrondis, alors que les objets viennent de se séparer) : le cas est seulement compté.
+    Time date = state.now + time;
+    if (mType != _area && (!mobile1->checkLastCollision(*this, date)) && (mType != _mobiles || (!state.mobiles[mIndex2]->checkLastCollision(*this, date))))
     {
-        std::cout << "rejected : " << *this << std::endl;
+        ++state.countDegeneres.repetees;
         return Time();
     }
 
-    return state.now + time;
-}
-
-// Comparaison.
-bool Collision::operator==(const Collision& collision) const
-{
-    if (mType != collision.mType)
-        return false;
-
-    else if (mType == _defaut)
-        return true;
-    else if (mType == _mobiles)
-        return (mMobile2 == collision.mMobile2 && mMobile1 == collision.mMobile1) || (mMobile2 == collision.mMobile1 && mMobile1 == collision.mMobile2);
-    else if (mType == _sommet)
-        return mMobile1 == collision.mMobile1 && mSommet == collision.mSommet;
-    else if (mType == _segment)
-        return mMobile1 == collision.mMobile1 && mSegment == collision.mSegment;
-    else if (mType == _area)
-        return mMobile1 == collision.mMobile1;
-    return false;
+    return date;
 }
 
 
 // Effectue la collision : calcul du changement de trajectoire et mise à jour des prochaines collisions.
-void Collision::doCollision(State& state)
+void Collision::doCollision(State& state) const
 {
-    mMobile1->setLastCollision(*this, state.now);
-
     if (mType == _defaut)
         return;
-    else if (mType == _mobiles)
+
+    Mobile* mobile1 = state.mobiles[mIndex1];
+    mobile1->synchronize(state);
+    mobile1->setLastCollision(*this, state.now);
+
+    if (mType == _mobiles)
     {
-        mMobile2->setLastCollision(*this, state.now);
-        return mMobile1->doCollision(mMobile2, state);
+        Mobile* mobile2 = state.mobiles[mIndex2];
+        mobile2->synchronize(state);
+        mobile2->setLastCollision(*this, state.now);
+        return PairesMobiles::doCollision(mobile1, mobile2, state);
     }
     else if (mType == _sommet)
-        return mMobile1->doCollision(mSommet, state);
+        return mobile1->doCollision(state.sommets[mIndex2], state);
     else if (mType == _segment)
-        return mMobile1->doCollision(mSegment, state);
+        return mobile1->doCollision(state.segments[mIndex2], state);
     else if (mType == _area)
-        return mMobile1->changeArea(state);
+        return mobile1->changeArea(state);
 }
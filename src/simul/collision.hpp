@@ -20,60 +20,71 @@
 #define COLLISION_HPP
 
 #include <iostream>
-
-#include "mobile.hpp"
 #include "time.hpp"
-#include "event.hpp"
 
-// Evénement de collision d'un mobile avec une autre mobile, un obstacle ou un changement de zone.
-class Collision : public Event
+class State;
+class Mobile;
+
+// Collision d'un mobile avec une autre mobile, un obstacle ou un changement de zone.
+// Les objets sont désignés par leurs indices dans les tables de l'état (mobiles, sommets, segments).
+class Collision
 {
 public:
+    enum Type
+    {
+        _defaut = 0, _mobiles = 1, _sommet = 2, _segment = 3, _area = 4
+    };
+
     // Affichage dans un flux standard.
     friend std::ostream& operator<<(std::ostream& flux, const Collision& collision);
 
-    // Effectue l'événement sur le simulateur en paramètre.
-    bool perform(Simulateur& simulateur, bool& isDraw);
-
     // Constructeurs.
-    Collision();
-    Collision(Mobile* mobile1, Mobile* mobile2);
-    Collision(Mobile* mobile, const Coord<double>& sommet);
-    Collision(Mobile* mobile, const Segment& segment);
-    Collision(Mobile* mobile); // Changement de zone.
+    inline Collision();
+    inline Collision(Type type, unsigned int index1, unsigned int index2 = 0);
 
-    // Détache les deux mobiles (appelé si l'un d'eux change de trajectoire).
-    void detach(const Mobile* mobile) const;
+    // Retire la collision des prévisions de l'autre mobile concerné.
+    void detach(const Mobile* mobile, State& state) const;
 
     // Calcule l'instant de cette collision.
-    Time time(State& state) const;
+    Time time(State& state, const Time& horizon = Time()) const;
 
     // Comparaison.
-    bool operator==(const Collision& collision) const;
+    inline bool operator==(const Collision& collision) const;
     inline bool operator!=(const Collision& collision) const;
     // Indique si une réelle collision à lieu.
     inline bool isReal() const;
+    // Indique si la collision concerne un obstacle (sommet ou segment).
+    inline bool isObstacle() const;
 
     // Effectue la collision : calcul du changement de trajectoire et mise à jour des prochaines collisions.
-    void doCollision(State& state);
+    void doCollision(State& state) const;
 
 private:
-    enum Type {_defaut, _mobiles, _sommet, _segment, _area};
-
-    // Eléments entrant en collision.
-    Mobile* mMobile1;
-    Mobile* mMobile2;
-    Coord<double> mSommet;
-    Segment mSegment;
     // Type de collision.
     Type mType;
+    // Mobile concerné, et autre mobile ou obstacle.
+    unsigned int mIndex1;
+    unsigned int mIndex2;
 };
 
+// Constructeurs.
+inline Collision::Collision() :
+    mType(_defaut), mIndex1(0), mIndex2(0) {}
+inline Collision::Collision(Type type, unsigned int index1, unsigned int index2) :
+    mType(type), mIndex1(index1), mIndex2(index2) {}
+
 // Comparaison.
+inline bool Collision::operator==(const Collision& collision) const
+    {return mType == collision.mType
+            && ((mIndex1 == collision.mIndex1 && mIndex2 == collision.mIndex2)
+                || (mType == _mobiles && mIndex1 == collision.mIndex2 && mIndex2 == collision.mIndex1));}
 inline bool Collision::operator!=(const Collision& collision) const
     {return !(*this == collision);}
 // Indique si une réelle collision à lieu.
 inline bool Collision::isReal() const
     {return mType != _area;}
+// Indique si la collision concerne un obstacle (sommet ou segment).
+inline bool Collision::isObstacle() const
+    {return mType == _sommet || mType == _segment;}
 
 #endif // COLLISION_HPP
@@ -20,52 +20,32 @@
 
 #include "simulateur.hpp"
 
-// Constructeur.
-BouleEvent::BouleEvent(Boule* boule) :
-    mBoule(boule)
-{
-}
-
-
-// Ajoute l'événement au simulateur en paramètre.
-void Event::addEvent(Simulateur&/* simulateur*/)
-{
-}
-
-void DrawEvent::addEvent(Simulateur& simulateur)
-{
-    simulateur.addDrawEvent();
-}
-
-void ValueEvent::addEvent(Simulateur& simulateur)
-{
-    simulateur.addValueEvent();
-}
-
-void CourbeEvent::addEvent(Simulateur& simulateur)
-{
-    simulateur.addCourbeEvent();
-}
-
-
 // Effectue l'événement sur le simulateur en paramètre.
-bool DrawEvent::perform(Simulateur& simulateur, bool& isDraw)
-{
-    isDraw = true;
-    return simulateur.performDrawEvent();
-}
-
-bool ValueEvent::perform(Simulateur& simulateur, bool&/* isDraw*/)
-{
-    return simulateur.performValueEvent();
-}
-
-bool CourbeEvent::perform(Simulateur& simulateur, bool&/* isDraw*/)
-{
-    return simulateur.performCourbeEvent();
-}
-
-bool BouleEvent::perform(Simulateur& simulateur, bool&/* isDraw*/)
-{
-    return simulateur.performBouleEvent(mBoule);
+bool Event::perform(Simulateur& simulateur, bool& isDraw) const
+{
+    if (mType == _draw)
+    {
+        isDraw = true;
+        return simulateur.performDrawEvent();
+    }
+    else if (mType == _value)
+        return simulateur.performValueEvent();
+    else if (mType == _courbe)
+        return simulateur.performCourbeEvent();
+    else if (mType == _mobile)
+        return simulateur.performMobileEvent(mIndex);
+    else if (mType == _boule)
+        return simulateur.performBouleEvent(mIndex);
+    return false;
+}
+
+// Ajoute l'événement suivant au simulateur en paramètre (pour les événements périodiques).
+void Event::addEvent(Simulateur& simulateur) const
+{
+    if (mType == _draw)
+        simulateur.addDrawEvent();
+    else if (mType == _value)
+        simulateur.addValueEvent();
+    else if (mType == _courbe)
+        simulateur.addCourbeEvent();
 }
@@ -20,52 +20,39 @@
 #define EVENT_HPP
 
 class Simulateur;
-class Boule;
 
-// Classe abstraite qui décrit un événement de la simulation.
+// Evénement de la simulation, codé par son type et l'indice de l'objet concerné.
 class Event
 {
 public:
-    // Effectue l'événement sur le simulateur en paramètre.
-    virtual bool perform(Simulateur& simulateur, bool& isDraw) = 0;
-    // Ajoute l'événement au simulateur en paramètre.
-    virtual void addEvent(Simulateur& simulateur);
-};
-
-// Evénement de dessin sur le widget.
-class DrawEvent : public Event
-{
-public:
-    virtual bool perform(Simulateur& simulateur, bool& isDraw);
-    virtual void addEvent(Simulateur& simulateur);
-};
-
-// Evénement de récupération de valeurs pour les courbes.
-class ValueEvent : public Event
-{
-public:
-    virtual bool perform(Simulateur& simulateur, bool& isDraw);
-    virtual void addEvent(Simulateur& simulateur);
-};
+    enum Type
+    {
+        _draw = 0,      // Dessin sur le widget.
+        _value = 1,     // Récupération de valeurs pour les courbes.
+        _courbe = 2,    // Affichage des courbes.
+        _mobile = 3,    // Prochaines collisions d'un mobile (une seule entrée par mobile).
+        _boule = 4      // Changement de population pour une particule.
+    };
+
+    // Constructeurs.
+    inline Event();
+    inline Event(Type type, unsigned int index = 0);
 
-// Evénement d'affichage des courbes.
-class CourbeEvent : public Event
-{
-public:
-    virtual bool perform(Simulateur& simulateur, bool& isDraw);
-    virtual void addEvent(Simulateur& simulateur);
-};
-
-// Evénement de changement de population pour une particule.
-class BouleEvent : public Event
-{
-public:
-    BouleEvent(Boule* boule);
-
-    virtual bool perform(Simulateur& simulateur, bool& isDraw);
+    // Effectue l'événement sur le simulateur en paramètre.
+    bool perform(Simulateur& simulateur, bool& isDraw) const;
+    // Ajoute l'événement suivant au simulateur en paramètre (pour les événements périodiques).
+    void addEvent(Simulateur& simulateur) const;
 
 private:
-    Boule* mBoule;
+    Type mType;
+    // Indice du mobile concerné.
+    unsigned int mIndex;
 };
 
+// Constructeurs.
+inline Event::Event() :
+    mType(_draw), mIndex(0) {}
+inline Event::Event(Type type, unsigned int index) :
+    mType(type), mIndex(index) {}
+
 #endif // EVENT_HPP
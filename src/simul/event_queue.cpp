@@ -0,0 +1,172 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "event_queue.hpp"
+
+// Identifiant invalide.
+const EventQueue::Handle EventQueue::none = -1;
+
+// Constructeur.
+EventQueue::EventQueue(Scheduler::Type type) :
+    mRecords(),
+    mFree(),
+    mType(type),
+    mScheduler(Scheduler::create(type)),
+    mSuspended(false),
+    mPending()
+{
+}
+
+
+// Vide la file.
+void EventQueue::clear()
+{
+    mRecords.clear();
+    mFree.clear();
+    mScheduler->clear();
+    mSuspended = false;
+    mPending.clear();
+}
+
+// Change d'ordonnanceur (les événements présents sont conservés).
+void EventQueue::setScheduler(Scheduler::Type type)
+{
+    if (type == mType)
+        return;
+
+    std::vector<std::pair<Handle, Time> > events;
+    for (Handle handle = 0 ; handle < mRecords.size() ; ++handle)
+        if (mScheduler->contains(handle))
+            events.push_back(std::make_pair(handle, mRecords[handle].mTime));
+
+    mType = type;
+    mScheduler = Scheduler::create(type);
+    mScheduler->pushAll(events);
+}
+
+// Décale toutes les dates de la durée indiquée.
+// L'ordonnanceur est reconstruit, car les calendriers dépendent des dates absolues.
+void EventQueue::recale(const Time& origine)
+{
+    std::vector<std::pair<Handle, Time> > events;
+    for (Handle handle = 0 ; handle < mRecords.size() ; ++handle)
+    {
+        mRecords[handle].mTime -= origine;
+        if (mScheduler->contains(handle))
+            events.push_back(std::make_pair(handle, mRecords[handle].mTime));
+    }
+
+    mScheduler = Scheduler::create(mType);
+    mScheduler->pushAll(events);
+}
+
+// Suspend l'ordonnancement.
+void EventQueue::suspend()
+{
+    mSuspended = true;
+}
+
+// Reprend l'ordonnancement, en y ajoutant en bloc les événements mis en attente.
+// Les événements retirés entre-temps sont ignorés, ainsi que les doublons laissés par un identifiant réutilisé.
+void EventQueue::resume()
+{
+    std::vector<std::pair<Handle, Time> > events;
+    events.reserve(mPending.size());
+    for (Handle handle : mPending)
+    {
+        Record& record = mRecords[handle];
+        if (record.mPending)
+        {
+            record.mPending = false;
+            events.push_back(std::make_pair(handle, record.mTime));
+        }
+    }
+
+    mSuspended = false;
+    mPending.clear();
+    mScheduler->pushAll(events);
+}
+
+// Met un événement en attente jusqu'à la reprise.
+void EventQueue::suspendRecord(Handle handle)
+{
+    mRecords[handle].mPending = true;
+    mPending.push_back(handle);
+}
+
+
+// Ajoute un événement et renvoie son identifiant.
+EventQueue::Handle EventQueue::insert(const Time& time, const Event& event)
+{
+    Handle handle;
+    if (mFree.empty())
+    {
+        handle = mRecords.size();
+        mRecords.push_back(Record());
+    }
+    else
+    {
+        handle = mFree.back();
+        mFree.pop_back();
+    }
+
+    Record& record = mRecords[handle];
+    record.mTime = time;
+    record.mEvent = event;
+    record.mPending = false;
+    if (mSuspended)
+        this->suspendRecord(handle);
+    else
+        mScheduler->push(handle, time);
+
+    return handle;
+}
+
+// Change la date d'un événement (le remet dans la file s'il en a été retiré).
+void EventQueue::update(Handle handle, const Time& time)
+{
+    // Un événement en attente sera ordonné à la reprise, à sa dernière date.
+    Record& record = mRecords[handle];
+    record.mTime = time;
+    if (record.mPending)
+        return;
+
+    if (mScheduler->contains(handle))
+        mScheduler->update(handle, time);
+    else if (mSuspended)
+        this->suspendRecord(handle);
+    else
+        mScheduler->push(handle, time);
+}
+
+// Retire un événement de la file (son identifiant reste valable).
+void EventQueue::remove(Handle handle)
+{
+    Record& record = mRecords[handle];
+    if (record.mPending)
+        record.mPending = false;
+    else if (mScheduler->contains(handle))
+        mScheduler->remove(handle);
+}
+
+// Supprime définitivement un événement.
+void EventQueue::erase(Handle handle)
+{
+    this->remove(handle);
+    mFree.push_back(handle);
+}
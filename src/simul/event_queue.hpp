@@ -0,0 +1,116 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef EVENT_QUEUE_HPP
+#define EVENT_QUEUE_HPP
+
+#include <vector>
+#include <memory>
+#include "time.hpp"
+#include "event.hpp"
+#include "scheduler.hpp"
+
+// File de priorité indexée contenant les événements de la simulation.
+// Les enregistrements sont stockés de manière contiguë et réutilisés : pas d'allocation en régime permanent.
+// Chaque événement inséré est désigné par un identifiant qui reste valable jusqu'à sa suppression,
+// y compris après avoir été retiré de la file par pop().
+// L'ordre des événements est délégué à un ordonnanceur interchangeable (tas ou calendrier).
+class EventQueue
+{
+public:
+    // Identifiant d'un événement.
+    typedef Scheduler::Handle Handle;
+    static const Handle none;
+
+    // Constructeur.
+    EventQueue(Scheduler::Type type = Scheduler::_heap);
+
+    // Vide la file.
+    void clear();
+    // Change d'ordonnanceur (les événements présents sont conservés).
+    void setScheduler(Scheduler::Type type);
+    // Décale toutes les dates de la durée indiquée (changement d'origine des temps).
+    void recale(const Time& origine);
+    // Suspend l'ordonnancement : les événements ajoutés ou remis dans la file ne sont ordonnés qu'à la reprise,
+    // tous ensemble (remplissage initial). Ils peuvent être modifiés ou retirés entre-temps, mais top() et pop()
+    // ne voient que les événements déjà ordonnés.
+    void suspend();
+    // Reprend l'ordonnancement, en y ajoutant en bloc les événements mis en attente.
+    void resume();
+
+    // Ajoute un événement et renvoie son identifiant.
+    Handle insert(const Time& time, const Event& event);
+    // Change la date d'un événement (le remet dans la file s'il en a été retiré).
+    void update(Handle handle, const Time& time);
+    // Retire un événement de la file (son identifiant reste valable).
+    void remove(Handle handle);
+    // Supprime définitivement un événement.
+    void erase(Handle handle);
+    // Retire le prochain événement de la file (son identifiant reste valable).
+    inline void pop();
+
+    // Accesseurs.
+    inline bool empty() const;
+    inline unsigned int size() const;
+    inline Handle top() const;
+    inline Scheduler::Type schedulerType() const;
+    inline const Time& time(Handle handle) const;
+    inline const Event& event(Handle handle) const;
+
+private:
+    // Enregistrement d'un événement.
+    struct Record
+    {
+        Time mTime;
+        Event mEvent;
+        // En attente d'être ordonné (suspension en cours).
+        bool mPending;
+    };
+
+    // Met un événement en attente jusqu'à la reprise.
+    void suspendRecord(Handle handle);
+
+    // Enregistrements (contigus) et emplacements libres.
+    std::vector<Record> mRecords;
+    std::vector<Handle> mFree;
+    // Ordre des événements, et événements en attente pendant une suspension.
+    Scheduler::Type mType;
+    std::unique_ptr<Scheduler> mScheduler;
+    bool mSuspended;
+    std::vector<Handle> mPending;
+};
+
+// Retire le prochain événement de la file.
+inline void EventQueue::pop()
+    {mScheduler->remove(mScheduler->top());}
+
+// Accesseurs.
+inline bool EventQueue::empty() const
+    {return !mScheduler->size();}
+inline unsigned int EventQueue::size() const
+    {return mScheduler->size();}
+inline EventQueue::Handle EventQueue::top() const
+    {return mScheduler->top();}
+inline Scheduler::Type EventQueue::schedulerType() const
+    {return mType;}
+inline const Time& EventQueue::time(Handle handle) const
+    {return mRecords[handle].mTime;}
+inline const Event& EventQueue::event(Handle handle) const
+    {return mRecords[handle].mEvent;}
+
+#endif // EVENT_QUEUE_HPP
@@ -0,0 +1,119 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef GRAVITE_HPP
+#define GRAVITE_HPP
+
+#include "coord.hpp"
+#include "solveur.hpp"
+#include "time.hpp"
+
+// Politiques de gravité.
+// La gravité est fixée pour toute la simulation : State::create choisit une fois la politique correspondante,
+// et les calculs de trajectoire sont instanciés pour chacune (sans gravité, il ne reste que des équations
+// du premier degré).
+class Gravite
+{
+public:
+    enum Type
+    {
+        _nulle = 0, _verticale = 1, _generale = 2
+    };
+
+    // Politiques : composantes de la gravité qui peuvent être non nulles.
+    struct Nulle
+    {
+        static constexpr bool horizontale = false;
+        static constexpr bool verticale = false;
+    };
+    struct Verticale
+    {
+        static constexpr bool horizontale = false;
+        static constexpr bool verticale = true;
+    };
+    struct Generale
+    {
+        static constexpr bool horizontale = true;
+        static constexpr bool verticale = true;
+    };
+
+    // Politique correspondant au vecteur de gravité.
+    static inline Type type(const Coord<double>& gravity);
+    // Appelle la fonction avec la politique indiquée.
+    template <typename Function>
+    static inline auto applique(Type type, Function function) -> decltype(function(Nulle()));
+
+    // Premier instant où une coordonnée (position, vitesse, et éventuellement accélération) sort de [min, max].
+    static inline Time sortie(double position, double vitesse, double min, double max);
+    static inline Time sortie(double position, double vitesse, double acceleration, double min, double max);
+};
+
+// Politique correspondant au vecteur de gravité.
+inline Gravite::Type Gravite::type(const Coord<double>& gravity)
+{
+    if (gravity.x != 0.0)
+        return _generale;
+    if (gravity.y != 0.0)
+        return _verticale;
+    return _nulle;
+}
+
+// Appelle la fonction avec la politique indiquée.
+template <typename Function>
+inline auto Gravite::applique(Type type, Function function) -> decltype(function(Nulle()))
+{
+    if (type == _nulle)
+        return function(Nulle());
+    if (type == _verticale)
+        return function(Verticale());
+    return function(Generale());
+}
+
+// Premier instant où une coordonnée sort de [min, max], en mouvement uniforme.
+inline Time Gravite::sortie(double position, double vitesse, double min, double max)
+{
+    if (vitesse > 0)
+        return (max - position) / vitesse;
+    if (vitesse < 0)
+        return (min - position) / vitesse;
+    return Time();
+}
+
+// Premier instant où une coordonnée sort de [min, max], en mouvement uniformément accéléré
+// (première ou seconde solution selon le signe de l'accélération).
+inline Time Gravite::sortie(double position, double vitesse, double acceleration, double min, double max)
+{
+    Time result;
+    Time tmp;
+    if (acceleration < 0.0)
+    {
+        result = Solveur::fstQuadratique(acceleration / 2.0, vitesse, position - max);
+        tmp = Solveur::sndQuadratique(acceleration / 2.0, vitesse, position - min);
+    }
+    else if (acceleration > 0.0)
+    {
+        result = Solveur::sndQuadratique(acceleration / 2.0, vitesse, position - max);
+        tmp = Solveur::fstQuadratique(acceleration / 2.0, vitesse, position - min);
+    }
+    else
+        return Gravite::sortie(position, vitesse, min, max);
+
+    return tmp < result ? tmp : result;
+}
+
+#endif // GRAVITE_HPP
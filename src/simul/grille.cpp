@@ -0,0 +1,153 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "grille.hpp"
+
+#include "coord.tpl"
+
+// Constructeur.
+Grille::Grille() :
+    mSizeArea(1),
+    mRayon(0),
+    mPeau(0),
+    mMin(),
+    mSize(),
+    mCells(),
+    mRows(),
+    mSparseRows()
+{
+}
+
+
+// Vide la grille.
+void Grille::clear()
+{
+    mMin = Coord<int>();
+    mSize = Coord<int>();
+    mCells.clear();
+    mRows.clear();
+    mSparseRows.clear();
+}
+
+// Définit la taille des cases (et le rayon maximal des boules correspondantes), et prépare la partie contiguë
+// pour le rectangle [min, max], sauf si elle contiendrait beaucoup plus de cases que d'objets (count).
+void Grille::resize(double sizeArea, double rayon, const Coord<double>& minPoint, const Coord<double>& maxPoint, unsigned int count)
+{
+    this->clear();
+    mSizeArea = sizeArea;
+    mRayon = rayon;
+    mPeau = sizeArea - rayon;
+    if (maxPoint.x < minPoint.x || maxPoint.y < minPoint.y)
+        return;
+
+    // Rectangle de cases, élargi d'une case pour les zones voisines.
+    Coord<int> min = this->area(minPoint) - Coord<int>(1, 1);
+    Coord<int> max = this->area(maxPoint) + Coord<int>(1, 1);
+
+    double cells = (double)(max.x - min.x + 1) * (max.y - min.y + 1);
+    if (cells > minDenseCells && cells > (double)maxCellsPerObject * count)
+        return;
+
+    mMin = min;
+    mSize = Coord<int>(max.x - min.x + 1, max.y - min.y + 1);
+    mCells.resize(mSize.x * mSize.y);
+    mRows.resize(mSize.y);
+}
+
+
+// Case indiquée (créée si nécessaire).
+Grille::Cell& Grille::cell(const Coord<int>& area)
+{
+    if (this->dense(area))
+        return mCells[(area.y - mMin.y) * mSize.x + (area.x - mMin.x)];
+
+    if ((unsigned int)(area.y - mMin.y) < (unsigned int)mSize.y)
+        return mRows[area.y - mMin.y].mCells[area.x];
+    return mSparseRows[area.y].mCells[area.x];
+}
+
+// Supprime la case si elle est extérieure et vide.
+void Grille::release(const Coord<int>& area)
+{
+    if (this->dense(area))
+        return;
+
+    bool denseRow = (unsigned int)(area.y - mMin.y) < (unsigned int)mSize.y;
+    auto sparseRow = mSparseRows.end();
+    Row* row;
+    if (denseRow)
+        row = &mRows[area.y - mMin.y];
+    else
+    {
+        sparseRow = mSparseRows.find(area.y);
+        if (sparseRow == mSparseRows.end())
+            return;
+        row = &sparseRow->second;
+    }
+
+    auto it = row->mCells.find(area.x);
+    if (it == row->mCells.end())
+        return;
+
+    const Cell& cell = it->second;
+    if (cell.mBoules.empty() && cell.mSommets.empty() && cell.mSegments.empty())
+    {
+        row->mCells.erase(it);
+        if (!denseRow && row->mCells.empty() && row->mPistons.empty())
+            mSparseRows.erase(sparseRow);
+    }
+}
+
+
+// Pistons présents sur une ligne.
+std::vector<Piston*>& Grille::pistons(int y)
+{
+    if ((unsigned int)(y - mMin.y) < (unsigned int)mSize.y)
+        return mRows[y - mMin.y].mPistons;
+    return mSparseRows[y].mPistons;
+}
+
+// Boules présentes sur une ligne.
+std::vector<Boule*>& Grille::boules(int y)
+{
+    if ((unsigned int)(y - mMin.y) < (unsigned int)mSize.y)
+        return mRows[y - mMin.y].mBoules;
+    return mSparseRows[y].mBoules;
+}
+
+
+// Recherche une ligne.
+const Grille::Row* Grille::findRow(int y) const
+{
+    if ((unsigned int)(y - mMin.y) < (unsigned int)mSize.y)
+        return &mRows[y - mMin.y];
+
+    auto it = mSparseRows.find(y);
+    return it == mSparseRows.end() ? nullptr : &it->second;
+}
+
+// Recherche une case hors de la partie contiguë.
+const Grille::Cell* Grille::findSparse(const Coord<int>& area) const
+{
+    const Row* row = this->findRow(area.y);
+    if (!row)
+        return nullptr;
+
+    auto it = row->mCells.find(area.x);
+    return it == row->mCells.end() ? nullptr : &it->second;
+}
@@ -0,0 +1,156 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef GRILLE_HPP
+#define GRILLE_HPP
+
+#include <cmath>
+#include <vector>
+#include <unordered_map>
+#include "coord.hpp"
+
+class Boule;
+class Piston;
+
+// Pavage de l'espace en cases carrées, répertoriant les objets présents dans chaque case.
+// Chaque grille correspond à une classe de rayons : sa taille de case est adaptée aux plus grosses boules de la classe.
+// Avec les listes de voisins, chaque boule est répertoriée dans la case de la position où sa liste a été construite,
+// et peut s'en éloigner de "peau" dans chaque direction : la peau est la plus grande pour laquelle la boule reste
+// dans les cases voisines.
+// Les cases du rectangle englobant le domaine sont stockées de manière contiguë (accès direct) ;
+// les autres (domaine non borné, ou trop creux) sont créées à la demande dans des tables de hachage.
+// Chaque ligne répertorie aussi ses boules et ses pistons : les pistons couvrent toute la largeur, et parcourent
+// les boules des lignes voisines sans passer par leurs cases (vides pour la plupart dans un domaine large).
+// Les boules d'une ligne n'y sont rangées qu'en présence de pistons, triées par vitesse verticale (voir Piston).
+class Grille
+{
+public:
+    // Contenu d'une case.
+    struct Cell
+    {
+        // Boules (chaque boule connaît sa position dans le tableau).
+        std::vector<Boule*> mBoules;
+        // Sommets et segments des obstacles présents dans cette case ou ses voisines
+        // (indices dans les tables de l'état, sans doublon).
+        std::vector<unsigned int> mSommets;
+        std::vector<unsigned int> mSegments;
+    };
+
+    // Constructeur.
+    Grille();
+
+    // Vide la grille.
+    void clear();
+    // Définit la taille des cases (et le rayon maximal des boules correspondantes), et prépare la partie contiguë
+    // pour le rectangle [min, max], sauf si elle contiendrait beaucoup plus de cases que d'objets (count).
+    void resize(double sizeArea, double rayon, const Coord<double>& min, const Coord<double>& max, unsigned int count);
+
+    // Accesseurs.
+    inline double sizeArea() const;
+    inline double rayon() const;
+    inline double peau() const;
+    // Case contenant le point.
+    inline Coord<int> area(const Coord<double>& point) const;
+
+    // Case indiquée (créée si nécessaire).
+    Cell& cell(const Coord<int>& area);
+    // Case indiquée (nullptr si elle n'existe pas).
+    inline const Cell* find(const Coord<int>& area) const;
+    // Supprime la case si elle est extérieure et vide.
+    void release(const Coord<int>& area);
+
+    // Pistons présents sur une ligne.
+    std::vector<Piston*>& pistons(int y);
+    inline const std::vector<Piston*>* findPistons(int y) const;
+    // Boules présentes sur une ligne (triées par vitesse verticale ramenée à l'origine des temps).
+    std::vector<Boule*>& boules(int y);
+    inline const std::vector<Boule*>* findBoules(int y) const;
+
+private:
+    // Nombre de cases en deçà duquel la partie contiguë est toujours utilisée.
+    static const unsigned int minDenseCells = 1 << 16;
+    // Nombre maximal de cases par objet pour utiliser la partie contiguë.
+    static const unsigned int maxCellsPerObject = 16;
+
+    // Ligne de cases : pistons, boules de toutes les cases de la ligne, et cases hors de la partie contiguë.
+    struct Row
+    {
+        std::vector<Piston*> mPistons;
+        std::vector<Boule*> mBoules;
+        std::unordered_map<int, Cell> mCells;
+    };
+
+    // Recherche une ligne.
+    const Row* findRow(int y) const;
+    // Recherche une case hors de la partie contiguë.
+    const Cell* findSparse(const Coord<int>& area) const;
+    // Indique si la case fait partie de la partie contiguë.
+    inline bool dense(const Coord<int>& area) const;
+
+    // Taille des cases, rayon maximal des boules et peau des listes de voisins.
+    double mSizeArea;
+    double mRayon;
+    double mPeau;
+    // Partie contiguë : cases du rectangle [mMin, mMin + mSize[ (rangées par ligne) et lignes correspondantes.
+    Coord<int> mMin;
+    Coord<int> mSize;
+    std::vector<Cell> mCells;
+    std::vector<Row> mRows;
+    // Lignes hors de la partie contiguë.
+    std::unordered_map<int, Row> mSparseRows;
+};
+
+// Accesseurs.
+inline double Grille::sizeArea() const
+    {return mSizeArea;}
+inline double Grille::rayon() const
+    {return mRayon;}
+inline double Grille::peau() const
+    {return mPeau;}
+
+// Case contenant le point.
+inline Coord<int> Grille::area(const Coord<double>& point) const
+    {return Coord<int>(std::floor(point.x / mSizeArea), std::floor(point.y / mSizeArea));}
+
+// Indique si la case fait partie de la partie contiguë.
+inline bool Grille::dense(const Coord<int>& area) const
+    {return (unsigned int)(area.x - mMin.x) < (unsigned int)mSize.x && (unsigned int)(area.y - mMin.y) < (unsigned int)mSize.y;}
+
+// Case indiquée (nullptr si elle n'existe pas).
+inline const Grille::Cell* Grille::find(const Coord<int>& area) const
+{
+    if (this->dense(area))
+        return &mCells[(area.y - mMin.y) * mSize.x + (area.x - mMin.x)];
+    return this->findSparse(area);
+}
+
+// Pistons présents sur une ligne.
+inline const std::vector<Piston*>* Grille::findPistons(int y) const
+{
+    const Row* row = this->findRow(y);
+    return row ? &row->mPistons : nullptr;
+}
+
+// Boules présentes sur une ligne.
+inline const std::vector<Boule*>* Grille::findBoules(int y) const
+{
+    const Row* row = this->findRow(y);
+    return row ? &row->mBoules : nullptr;
+}
+
+#endif // GRILLE_HPP
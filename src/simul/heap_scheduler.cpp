@@ -0,0 +1,165 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "heap_scheduler.hpp"
+
+#include <algorithm>
+
+// Position invalide.
+const unsigned int HeapScheduler::none;
+
+// Constructeur.
+HeapScheduler::HeapScheduler() :
+    mHeap(),
+    mPositions()
+{
+}
+
+
+// Vide la structure.
+void HeapScheduler::clear()
+{
+    mHeap.clear();
+    mPositions.clear();
+}
+
+
+// Ajoute un événement.
+void HeapScheduler::push(Handle handle, const Time& time)
+{
+    if (handle >= mPositions.size())
+        mPositions.resize(handle + 1, none);
+
+    Entry entry = {time, handle};
+    mHeap.push_back(entry);
+    this->siftUp(mHeap.size() - 1, entry);
+}
+
+// Ajoute des événements en bloc : ils sont placés à la suite, puis le tas est reconstruit de bas en haut
+// (en temps linéaire, au lieu d'une remontée par événement).
+void HeapScheduler::pushAll(const std::vector<std::pair<Handle, Time> >& events)
+{
+    for (auto& event : events)
+    {
+        if (event.first >= mPositions.size())
+            mPositions.resize(event.first + 1, none);
+
+        Entry entry = {event.second, event.first};
+        mHeap.push_back(entry);
+        mPositions[event.first] = mHeap.size() - 1;
+    }
+
+    // Les noeuds internes sont descendus, du dernier à la racine.
+    if (mHeap.size() < 2)
+        return;
+    for (unsigned int position = (mHeap.size() - 2) / arity + 1 ; position-- > 0 ; )
+    {
+        Entry entry = mHeap[position];
+        this->siftDown(position, entry);
+    }
+}
+
+// Change la date d'un événement présent.
+void HeapScheduler::update(Handle handle, const Time& time)
+{
+    unsigned int position = mPositions[handle];
+    Entry entry = {time, handle};
+
+    if (time < mHeap[position].mTime)
+        this->siftUp(position, entry);
+    else
+        this->siftDown(position, entry);
+}
+
+// Retire un événement présent.
+void HeapScheduler::remove(Handle handle)
+{
+    unsigned int position = mPositions[handle];
+    mPositions[handle] = none;
+
+    Entry last = mHeap.back();
+    mHeap.pop_back();
+    if (position == mHeap.size())
+        return;
+
+    // Le dernier élément prend la place libérée.
+    if (position > 0 && last.mTime < mHeap[(position - 1) / arity].mTime)
+        this->siftUp(position, last);
+    else
+        this->siftDown(position, last);
+}
+
+
+// Indique si l'événement est présent.
+bool HeapScheduler::contains(Handle handle) const
+{
+    return handle < mPositions.size() && mPositions[handle] != none;
+}
+
+// Nombre d'événements présents.
+unsigned int HeapScheduler::size() const
+{
+    return mHeap.size();
+}
+
+// Prochain événement.
+Scheduler::Handle HeapScheduler::top()
+{
+    return mHeap.front().mHandle;
+}
+
+
+// Remonte un élément dans le tas.
+void HeapScheduler::siftUp(unsigned int position, const Entry& entry)
+{
+    while (position > 0)
+    {
+        unsigned int parent = (position - 1) / arity;
+        if (!(entry.mTime < mHeap[parent].mTime))
+            break;
+        this->place(position, mHeap[parent]);
+        position = parent;
+    }
+    this->place(position, entry);
+}
+
+// Descend un élément dans le tas.
+void HeapScheduler::siftDown(unsigned int position, const Entry& entry)
+{
+    unsigned int size = mHeap.size();
+
+    while (true)
+    {
+        // Recherche du plus petit fils.
+        unsigned int first = position * arity + 1;
+        if (first >= size)
+            break;
+        unsigned int last = std::min(first + arity, size);
+
+        unsigned int child = first;
+        for (unsigned int i = first + 1 ; i < last ; ++i)
+            if (mHeap[i].mTime < mHeap[child].mTime)
+                child = i;
+
+        if (!(mHeap[child].mTime < entry.mTime))
+            break;
+        this->place(position, mHeap[child]);
+        position = child;
+    }
+    this->place(position, entry);
+}
@@ -0,0 +1,74 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef HEAP_SCHEDULER_HPP
+#define HEAP_SCHEDULER_HPP
+
+#include <vector>
+#include "scheduler.hpp"
+
+// Ordonnanceur sous forme de tas 4-aire indexé.
+class HeapScheduler : public Scheduler
+{
+public:
+    // Constructeur.
+    HeapScheduler();
+
+    void clear();
+
+    void push(Handle handle, const Time& time);
+    void pushAll(const std::vector<std::pair<Handle, Time> >& events);
+    void update(Handle handle, const Time& time);
+    void remove(Handle handle);
+
+    bool contains(Handle handle) const;
+    unsigned int size() const;
+    Handle top();
+
+private:
+    // Elément du tas.
+    struct Entry
+    {
+        Time mTime;
+        Handle mHandle;
+    };
+
+    // Arité du tas.
+    static const unsigned int arity = 4;
+    // Position invalide.
+    static const unsigned int none = -1;
+
+    // Opérations sur le tas.
+    void siftUp(unsigned int position, const Entry& entry);
+    void siftDown(unsigned int position, const Entry& entry);
+    inline void place(unsigned int position, const Entry& entry);
+
+    // Tas des événements.
+    std::vector<Entry> mHeap;
+    // Position de chaque événement dans le tas.
+    std::vector<unsigned int> mPositions;
+};
+
+// Place un élément dans le tas.
+inline void HeapScheduler::place(unsigned int position, const Entry& entry)
+{
+    mHeap[position] = entry;
+    mPositions[entry.mHandle] = position;
+}
+
+#endif // HEAP_SCHEDULER_HPP
@@ -0,0 +1,101 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "instantane.hpp"
+
+#include <QPainter>
+#include "state.hpp"
+
+constexpr unsigned int Instantanes::indice;
+constexpr unsigned int Instantanes::frais;
+
+// Constructeur.
+Instantane::Instantane() :
+    mX(), mY(), mRayon(), mPopulation(),
+    mCouleurs(),
+    mPistonY(), mPistonEpaisseur(), mPistonCouleur()
+{
+}
+
+
+// Recopie l'état présent de la simulation.
+void Instantane::copie(const State& state)
+{
+    // Les tableaux gardent leur capacité d'un instantané à l'autre.
+    const Particules& particules = state.particules;
+    mX = particules.x;
+    mY = particules.y;
+    mRayon = particules.rayon;
+    mPopulation = particules.population;
+
+    mCouleurs.clear();
+    for (auto& population : state.populations)
+        mCouleurs.push_back(population.color());
+
+    mPistonY.clear();
+    mPistonEpaisseur.clear();
+    mPistonCouleur.clear();
+    for (auto& piston : state.pistons)
+    {
+        mPistonY.push_back(piston->position().y);
+        mPistonEpaisseur.push_back(piston->epaisseur());
+        mPistonCouleur.push_back(piston->color());
+    }
+}
+
+// Dessine l'instantané.
+void Instantane::draw(QPainter& painter, double left, double right) const
+{
+    // Dessin des pistons.
+    for (unsigned int i = 0 ; i < mPistonY.size() ; ++i)
+    {
+        painter.setBrush(mPistonCouleur[i]);
+        painter.drawRect(QRectF(left, mPistonY[i], right - left, mPistonEpaisseur[i]));
+    }
+
+    // Dessin des populations.
+    for (unsigned int i = 0 ; i < mX.size() ; ++i)
+    {
+        double rayon = mRayon[i];
+        painter.setBrush(mCouleurs[mPopulation[i]]);
+        painter.drawEllipse(QRectF(mX[i] - rayon, mY[i] - rayon, 2 * rayon, 2 * rayon));
+    }
+}
+
+// Constructeur.
+Instantanes::Instantanes() :
+    mEcriture(0),
+    mLecture(1),
+    mMilieu(2)
+{
+}
+
+
+// Publie le tampon rempli : il prend la place du tampon intermédiaire, qui sera rempli au prochain instantané.
+void Instantanes::publie()
+{
+    mEcriture = mMilieu.exchange(mEcriture | frais) & indice;
+}
+
+// Dernier instantané publié : le tampon intermédiaire n'est récupéré que s'il est nouveau.
+const Instantane& Instantanes::lecture()
+{
+    if (this->nouveau())
+        mLecture = mMilieu.exchange(mLecture) & indice;
+    return mTampons[mLecture];
+}
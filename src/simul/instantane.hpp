@@ -0,0 +1,93 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef INSTANTANE_HPP
+#define INSTANTANE_HPP
+
+#include <atomic>
+#include <vector>
+#include <QColor>
+
+class QPainter;
+class State;
+
+// Image de la simulation à un instant donné (positions, rayons et couleurs), recopiée depuis l'état
+// pour être dessinée par l'interface graphique pendant que la simulation continue.
+class Instantane
+{
+public:
+    // Constructeur.
+    Instantane();
+
+    // Recopie l'état présent de la simulation (les positions doivent être à jour).
+    void copie(const State& state);
+    // Dessine l'instantané, les pistons s'étendant entre les abscisses indiquées.
+    void draw(QPainter& painter, double left, double right) const;
+
+private:
+    // Boules.
+    std::vector<double> mX;
+    std::vector<double> mY;
+    std::vector<double> mRayon;
+    std::vector<unsigned int> mPopulation;
+    // Couleurs des populations.
+    std::vector<QColor> mCouleurs;
+    // Pistons.
+    std::vector<double> mPistonY;
+    std::vector<double> mPistonEpaisseur;
+    std::vector<QColor> mPistonCouleur;
+};
+
+// Triple tampon d'instantanés : la simulation remplit un tampon pendant que l'interface graphique dessine
+// le dernier publié, sans verrou ni attente de part et d'autre.
+class Instantanes
+{
+public:
+    // Constructeur.
+    Instantanes();
+
+    // Tampon à remplir (côté simulation).
+    inline Instantane& ecriture();
+    // Publie le tampon rempli, qui devient le plus récent.
+    void publie();
+
+    // Indique si un instantané a été publié depuis la dernière lecture (côté interface graphique).
+    inline bool nouveau() const;
+    // Dernier instantané publié (côté interface graphique).
+    const Instantane& lecture();
+
+private:
+    // Le tampon intermédiaire est échangé atomiquement, avec un drapeau indiquant qu'il n'a pas encore été lu.
+    static constexpr unsigned int indice = 3;
+    static constexpr unsigned int frais = 4;
+
+    Instantane mTampons[3];
+    unsigned int mEcriture;
+    unsigned int mLecture;
+    std::atomic<unsigned int> mMilieu;
+};
+
+// Tampon à remplir.
+inline Instantane& Instantanes::ecriture()
+    {return mTampons[mEcriture];}
+
+// Indique si un instantané a été publié depuis la dernière lecture.
+inline bool Instantanes::nouveau() const
+    {return mMilieu.load() & frais;}
+
+#endif // INSTANTANE_HPP
@@ -21,9 +21,6 @@
 #include "coord_io.tpl"
 #include "state.hpp"
 
-// Identifiant unique du dernier mobile.
-unsigned int Mobile::index = -1;
-
 // Affichage dans un flux standard.
 std::ostream& operator<<(std::ostream& flux, const Mobile& mobile)
 {
@@ -31,47 +28,66 @@ std::ostream& operator<<(std::ostream& flux, const Mobile& mobile)
     return flux;
 }
 
-// Comparaison pour utiliser un std::set.
-bool operator<(const std::multimap<Time, std::shared_ptr<Event> >::iterator& it1, const std::multimap<Time, std::shared_ptr<Event> >::iterator& it2)
-{
-    return it1->second.get() < it2->second.get();
-}
-
 
 // Constructeur.
-Mobile::Mobile(const Coord<double>& position, const Coord<double>& vitesse, const QColor& color, double masse) :
+Mobile::Mobile(Type type, const Coord<double>& position, const Coord<double>& vitesse, const QColor& color, double masse, State& state) :
     mPosition(position),
     mVitesse(vitesse),
     mMasse(masse),
+    mTime(state.now),
     mColor(color),
+    mCandidates(),
+    mHorizon(),
+    mSortie(),
     mTargetTime(),
-    mNextCollisions(),
-    mTargets(),
-    mAttached(),
-    mIndex(++Mobile::index)
+    mHandle(EventQueue::none),
+    mDirty(false),
+    mIndex(state.mobiles.size()),
+    mType(type)
 {
+    state.mobiles.push_back(this);
 }
 
 
-// Affiche la liste des cibles dans la sortie standard.
-void Mobile::showTargets() const
+// Affiche la liste des collisions prévues dans la sortie standard.
+void Mobile::showCandidates() const
 {
-    std::cout << "mTargets[" << *this << "].size() = " << mTargets.size() << std::endl;
-    for (auto& target : mTargets)
-        std::cout << "\ttarget : " << *target << std::endl;
+    std::cout << "mCandidates[" << *this << "].size() = " << mCandidates.size() << std::endl;
+    for (auto& candidate : mCandidates)
+        std::cout << "\t" << candidate.first << " : " << candidate.second << std::endl;
 }
 
 
-// Avance le mobile jusqu'à l'instant indiqué (sans tenir compte des autres mobiles).
-void Mobile::avance(const Time& time, const Coord<double>& gravity)
+// Amène le mobile à l'instant présent de la simulation (les mobiles ne sont avancés qu'à la demande).
+void Mobile::synchronize(const State& state)
+{
+    if (mTime != state.now)
+    {
+        Time time = state.now - mTime;
+        const Coord<double>& gravity = state.config.gravity();
+        Gravite::applique(state.gravite, [&](auto politique) {this->avance<decltype(politique)>(time, gravity);});
+        mTime = state.now;
+    }
+}
+
+// Amène le mobile à l'instant présent, qui devient la nouvelle origine des dates du mobile.
+// Les dates passées deviennent "jamais" (elles ne servent qu'à reconnaître une collision à l'instant présent).
+void Mobile::recale(State& state)
 {
-    mPosition += mVitesse * time.time() + gravity * time.time() * time.time() / 2;
-    mVitesse += gravity * time.time();
+    this->synchronize(state);
+
+    mTime = 0;
+    for (auto& candidate : mCandidates)
+        candidate.first -= state.now;
+    mHorizon -= state.now;
+    mSortie -= state.now;
+    mTargetTime -= state.now;
+    mLastTime -= state.now;
 }
 
 
 // Calcule l'instant de la prochaine collision avec le mobile.
-Time Mobile::collision(const Coord<double>&/* sommet*/, const Coord<double>&/* gravity*/) const
+Time Mobile::collision(const Coord<double>&/* sommet*/, const Coord<double>&/* gravity*/, const Time&/* limite*/) const
 {
     return Time();
 }
@@ -81,11 +97,17 @@ Time Mobile::collision(const Segment&/* segment*/, const Coord<double>&/* gravit
     return Time();
 }
 
-Time Mobile::newArea(double/* sizeArea*/, const Coord<double>&/* gravity*/) const
+Time Mobile::newArea(const State&/* state*/) const
 {
     return Time();
 }
 
+// Rectangle balayé par le mobile (épaisseur comprise) d'ici la limite (faux s'il n'est pas borné).
+bool Mobile::balayage(const Coord<double>&/* gravity*/, const Time&/* limite*/, Coord<double>&/* min*/, Coord<double>&/* max*/) const
+{
+    return false;
+}
+
 
 // Effectue la collision avec le mobile : calcul du changement de trajectoire et mise à jour des prochaines collisions.
 void Mobile::doCollision(const Coord<double>&/* sommet*/, State& state)
@@ -110,7 +132,7 @@ void Mobile::setLastCollision(const Collision& collision, const Time& now)
 {
     if (mLastTime != now)
         mLastCollisions.clear();
-    mLastCollisions.push_back(std::make_shared<Collision>(collision));
+    mLastCollisions.push_back(collision);
     mLastTime = now;
 }
 
@@ -118,134 +140,194 @@ void Mobile::setLastCollision(const Collision& collision, const Time& now)
 bool Mobile::checkLastCollision(const Collision& collision, const Time& time) const
 {
     for (auto& lastCollision : mLastCollisions)
-        if (*lastCollision == collision && mLastTime == time)
+        if (lastCollision == collision && mLastTime == time)
             return false;
     return true;
 }
 
 
-// Cherche la prochaine collision de ce mobile et met à jour la table des événements.
+// Cherche les prochaines collisions de ce mobile (jusqu'à son prochain changement de zone).
 void Mobile::updateCollisions(State& state)
 {
-    mTargetTime = Time();
+    this->synchronize(state);
     this->detach(state);
 
+    // Le changement de zone est cherché en premier : il borne la recherche des obstacles, et celle des autres
+    // collisions en recherche limitée.
+    this->updateHorizon(state);
+
     // Recherche des collisions avec des mobiles.
     this->updateCollisionsMobiles(state);
 }
 
-// Détache le mobile de la collision (appelé en cas de changement de trajectoire).
-void Mobile::detach(const Collision& collision)
+// Supprime toutes les collisions prévues du mobile, y compris chez les autres mobiles concernés.
+void Mobile::detach(State& state)
+{
+    if (mCandidates.empty())
+        return;
+
+    for (auto& candidate : mCandidates)
+        candidate.second.detach(this, state);
+    mCandidates.clear();
+
+    this->invalidate(state);
+}
+
+// Détache le mobile de la collision (appelé si l'autre mobile change de trajectoire).
+void Mobile::detach(const Collision& collision, State& state)
 {
-    for (auto it = mNextCollisions.begin() ; it != mNextCollisions.end() ; ++it)
+    for (auto it = mCandidates.begin() ; it != mCandidates.end() ; ++it)
     {
-        if (*std::dynamic_pointer_cast<Collision>((*it)->second) == collision)
+        if (it->second == collision)
         {
-            mNextCollisions.erase(it);
+            if (it->first == mTargetTime)
+                this->invalidate(state);
+
+            *it = mCandidates.back();
+            mCandidates.pop_back();
             break;
         }
     }
 }
 
+// Extrait une collision prévue à l'instant présent (renvoie false s'il n'y en a plus).
+bool Mobile::nextCollision(Collision& collision, State& state)
+{
+    // L'entrée du mobile vient d'être retirée de la table des événements.
+    this->invalidate(state);
+
+    for (auto it = mCandidates.begin() ; it != mCandidates.end() ; ++it)
+    {
+        if (it->first == state.now)
+        {
+            collision = it->second;
+            *it = mCandidates.back();
+            mCandidates.pop_back();
 
-// Ajoute tous les mobiles attachés (i.e. qui ciblent celui-ci) à l'ensemble à mettre à jour.
+            // Une collision entre deux mobiles n'est effectuée qu'une fois.
+            collision.detach(this, state);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Met à jour l'entrée du mobile dans la table des événements.
+void Mobile::schedule(State& state)
+{
+    mDirty = false;
+
+    mTargetTime = Time();
+    for (auto& candidate : mCandidates)
+        if (candidate.first < mTargetTime)
+            mTargetTime = candidate.first;
+
+    if (mTargetTime.isNever())
+    {
+        if (mHandle != EventQueue::none)
+            state.events.remove(mHandle);
+    }
+    else if (mHandle == EventQueue::none)
+        mHandle = state.events.insert(mTargetTime, Event(Event::_mobile, mIndex));
+    else
+        state.events.update(mHandle, mTargetTime);
+}
+
+
+// Ajoute le mobile à l'ensemble à mettre à jour.
 void Mobile::updateRefresh(State& state)
 {
     state.toRefresh.insert(this);
-    for (auto& attached : mAttached)
-        state.toRefresh.insert(attached);
+}
+
+// Cherche le prochain changement de zone, qui borne la recherche des obstacles, et celle des autres collisions
+// en recherche limitée.
+void Mobile::updateHorizon(State& state)
+{
+    mHorizon = Time();
+    mSortie = this->testeCollision(Collision(Collision::_area, mIndex), state);
+    if (this->limitedSearch(state))
+        mHorizon = mSortie;
+}
+
+// Indique si les collisions ne sont cherchées que jusqu'au prochain changement de zone.
+bool Mobile::limitedSearch(const State&/* state*/) const
+{
+    return true;
 }
 
 
 // Teste la collision avec l'autre mobile.
 void Mobile::testeCollision(Mobile* mobile, State& state)
 {
-    Collision collision(this, mobile);
-    Time time = collision.time(state);
-
-    if (time < state.now || time.isNever())
+    // La collision a déjà été étudiée par l'autre mobile.
+    Collision collision(Collision::_mobiles, mIndex, mobile->mIndex);
+    if (this->isCandidate(collision))
         return;
 
-    // La collision a lieu avant celle prévue précédemment.
-    if (time < mTargetTime)
-    {
-        mTargetTime = time;
-        this->detach(state);
-    }
-    if (time < mobile->mTargetTime)
-    {
-        mobile->mTargetTime = time;
-        mobile->detach(state);
-    }
+    Time time = collision.time(state);
+    if (time < state.now || time.isNever() || mHorizon < time)
+        return;
 
-    bool add = true;
-    if (time == mTargetTime)
-        add = !this->addTarget(mobile, state);
-    if (time == mobile->mTargetTime)
-        mobile->addTarget(this, state, add);
+    this->addCandidate(time, collision, state);
+    mobile->addCandidate(time, collision, state);
 }
 
-// Teste la collision.
-void Mobile::testeCollision(const Collision& collision, State& state)
+// Ajoute la collision avec l'autre mobile, dont l'instant a déjà été calculé (par lot).
+void Mobile::testeCollision(Mobile* mobile, const Time& time, State& state)
 {
-    Time time = collision.time(state);
-    if (time < state.now || time.isNever())
+    if (time < state.now || time.isNever() || mHorizon < time)
         return;
 
-    // La collision a lieu avant celle prévue précédemment.
-    if (time < mTargetTime)
+    // Empêche d'effectuer la même collision deux fois au même instant (voir Collision::time).
+    Collision collision(Collision::_mobiles, mIndex, mobile->mIndex);
+    if (!this->checkLastCollision(collision, time) && !mobile->checkLastCollision(collision, time))
     {
-        mTargetTime = time;
-        this->detach(state);
+        ++state.countDegeneres.repetees;
+        return;
     }
 
-    if (time == mTargetTime)
-        mNextCollisions.insert(
-                    state.events.insert(
-                        std::make_pair(
-                            mTargetTime,
-                            std::make_shared<Collision>(collision)
-                        )));
+    this->addCandidate(time, collision, state);
+    mobile->addCandidate(time, collision, state);
 }
 
-
-// Supprime le mobile de la liste des événements.
-void Mobile::detach(State& state)
+// Teste la collision (celle avec un obstacle n'est cherchée que jusqu'au prochain changement de zone).
+Time Mobile::testeCollision(const Collision& collision, State& state)
 {
-    // Supprime les prochaines collisions (cibles) de la liste des événements et des mobiles concernés.
-    for (auto it = mNextCollisions.begin() ; it != mNextCollisions.end() ; ++it)
-    {
-        std::shared_ptr<Event> copy = (*it)->second;
-        state.events.erase(*it);
-        std::dynamic_pointer_cast<Collision>(copy)->detach(this);
-    }
-    mNextCollisions.clear();
+    const Time& horizon = collision.isObstacle() ? mSortie : mHorizon;
+    Time time = collision.time(state, horizon);
+    if (time < state.now || time.isNever() || horizon < time)
+        return Time();
+
+    this->addCandidate(time, collision, state);
+    return time;
+}
+
 
-    // Détache ce mobile de ses cibles.
-    for (auto& target : mTargets)
-        target->mAttached.erase(this);
-    mTargets.clear();
+// Indique si la collision est déjà prévue.
+bool Mobile::isCandidate(const Collision& collision) const
+{
+    for (auto& candidate : mCandidates)
+        if (candidate.second == collision)
+            return true;
+    return false;
 }
 
-// Ajoute un mobile à la liste des cibles.
-bool Mobile::addTarget(Mobile* mobile, State& state, bool addCollision)
+// Ajoute une collision prévue.
+void Mobile::addCandidate(const Time& time, const Collision& collision, State& state)
 {
-    // Crée le double lien.
-    mTargets.insert(mobile);
-    mobile->mAttached.insert(this);
+    mCandidates.push_back(std::make_pair(time, collision));
+    if (time < mTargetTime)
+        this->invalidate(state);
+}
 
-    // Ajoute la collision à la liste des événements si nécessaire.
-    if (addCollision && mobile->mTargets.find(this) != mobile->mTargets.end())
+// Indique que l'entrée du mobile dans la table des événements doit être mise à jour.
+void Mobile::invalidate(State& state)
+{
+    if (!mDirty)
     {
-        auto it = state.events.insert(
-                    std::make_pair(
-                        mTargetTime,
-                        std::make_shared<Collision>(this, mobile)
-                    ));
-        mNextCollisions.insert(it);
-        mobile->mNextCollisions.insert(it);
-        return true;
+        mDirty = true;
+        state.toSchedule.push_back(this);
     }
-
-    return false;
 }
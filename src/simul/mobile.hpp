@@ -23,33 +23,37 @@
 #include <QMultiMap>
 #include <map>
 #include <set>
-#include <unordered_set>
+#include <vector>
 #include <memory>
 
 #include "coord.hpp"
 
 #include "time.hpp"
+#include "gravite.hpp"
+#include "event_queue.hpp"
+#include "collision.hpp"
 #include "segment.hpp"
 #include "polygone.hpp"
 
 class State;
-class Collision;
 class Piston;
 class Boule;
-class Event;
-
-// Comparaison pour utiliser un std::set.
-bool operator<(const std::multimap<Time, std::shared_ptr<Event> >::iterator& it1, const std::multimap<Time, std::shared_ptr<Event> >::iterator& it2);
 
 // Classe abstraite définissant un mobile (position, vitesse, masse, couleur).
 class Mobile
 {
 public:
+    // Types de mobiles (dans l'ordre des types de la classe Paires).
+    enum Type
+    {
+        _boule = 0, _piston = 1
+    };
+
     // Affichage dans un flux standard.
     friend std::ostream& operator<<(std::ostream& flux, const Mobile& mobile);
 
     // Constructeur.
-    Mobile(const Coord<double>& position, const Coord<double>& vitesse, const QColor& color, double masse);
+    Mobile(Type type, const Coord<double>& position, const Coord<double>& vitesse, const QColor& color, double masse, State& state);
 
     // Accesseurs.
     inline const Coord<double>& position() const;
@@ -57,27 +61,32 @@ public:
     inline double masse() const;
     inline QColor color() const;
     inline unsigned int id() const;
-
-    // Affiche la liste des cibles dans la sortie standard.
-    void showTargets() const;
-
-    // Avance le mobile jusqu'à l'instant indiqué (sans tenir compte des autres mobiles).
-    virtual void avance(const Time& time, const Coord<double>& gravity);
-
-    // Calcule l'instant de la prochaine collision avec le mobile.
-    virtual Time collision(const Mobile* mobile) const = 0;
-    virtual Time collision(const Boule* boule) const = 0;
-    virtual Time collision(const Piston* piston) const = 0;
-    // Calcule l'instant de la prochaine collision avec l'obstacle.
-    virtual Time collision(const Coord<double>& sommet, const Coord<double>& gravity) const;
+    inline Type type() const;
+    // Vitesse verticale ramenée à l'origine des temps : constante tant que la trajectoire ne change pas
+    // (la gravité est la même pour tous les mobiles).
+    inline double vitesseOrigine(const Coord<double>& gravity) const;
+
+    // Affiche la liste des collisions prévues dans la sortie standard.
+    void showCandidates() const;
+
+    // Avance le mobile jusqu'à l'instant indiqué (sans tenir compte des autres mobiles), selon la politique de gravité.
+    template <typename Politique>
+    inline void avance(const Time& time, const Coord<double>& gravity);
+    // Amène le mobile à l'instant présent de la simulation (les mobiles ne sont avancés qu'à la demande).
+    void synchronize(const State& state);
+    // Amène le mobile à l'instant présent, qui devient la nouvelle origine des dates du mobile.
+    virtual void recale(State& state);
+
+    // Calcule l'instant de la prochaine collision avec l'obstacle
+    // (les collisions entre mobiles sont aiguillées selon leurs types par la classe Paires).
+    virtual Time collision(const Coord<double>& sommet, const Coord<double>& gravity, const Time& limite) const;
     virtual Time collision(const Segment& segment, const Coord<double>& gravity) const;
     // Calcule l'instant du prochain changement de zone.
-    virtual Time newArea(double sizeArea, const Coord<double>& gravity) const;
+    virtual Time newArea(const State& state) const;
+    // Rectangle balayé par le mobile (épaisseur comprise) d'ici la limite (faux s'il n'est pas borné).
+    virtual bool balayage(const Coord<double>& gravity, const Time& limite, Coord<double>& min, Coord<double>& max) const;
 
-    // Effectue la collision avec le mobile : calcul du changement de trajectoire et mise à jour des prochaines collisions.
-    virtual void doCollision(Mobile* mobile, State& state) = 0;
-    virtual void doCollision(Boule* boule, State& state) = 0;
-    virtual void doCollision(Piston* piston, State& state) = 0;
+    // Effectue la collision avec l'obstacle : calcul du changement de trajectoire et mise à jour des prochaines collisions.
     virtual void doCollision(const Coord<double>& sommet, State& state);
     virtual void doCollision(const Segment& segment, State& state);
     // Effectue un changement de zone.
@@ -88,50 +97,87 @@ public:
     // Vérifie que la collision est compatible avec la dernière collision du mobile.
     bool checkLastCollision(const Collision& collision, const Time& time) const;
 
-    // Cherche la prochaine collision de ce mobile et met à jour la table des événements.
+    // Cherche les prochaines collisions de ce mobile (jusqu'à son prochain changement de zone).
     void updateCollisions(State& state);
-    // Détache le mobile de la collision (appelé en cas de changement de trajectoire).
-    void detach(const Collision& collision);
+    // Supprime toutes les collisions prévues du mobile, y compris chez les autres mobiles concernés.
+    void detach(State& state);
+    // Détache le mobile de la collision (appelé si l'autre mobile change de trajectoire).
+    void detach(const Collision& collision, State& state);
+    // Extrait une collision prévue à l'instant présent (renvoie false s'il n'y en a plus).
+    bool nextCollision(Collision& collision, State& state);
+    // Met à jour l'entrée du mobile dans la table des événements.
+    void schedule(State& state);
 
 protected:
-    // Ajoute tous les mobiles attachés (i.e. qui ciblent celui-ci) à l'ensemble à mettre à jour.
+    // Ajoute le mobile à l'ensemble à mettre à jour.
     void updateRefresh(State& state);
+    // Cherche le prochain changement de zone, qui borne la recherche des obstacles, et celle des autres collisions
+    // en recherche limitée.
+    void updateHorizon(State& state);
 
     // Cherche des collisions avec des mobiles.
     virtual void updateCollisionsMobiles(State& state) = 0;
-
-    // Teste la collision avec l'autre mobile.
+    // Indique si les collisions ne sont cherchées que jusqu'au prochain changement de zone
+    // (sinon elles sont toutes conservées, et un changement de zone n'ajoute que celles des objets nouvellement à portée).
+    virtual bool limitedSearch(const State& state) const;
+
+    // Indique si la collision est déjà prévue.
+    bool isCandidate(const Collision& collision) const;
+    // Horizon des collisions cherchées.
+    inline const Time& horizon() const;
+    // Teste la collision avec l'autre mobile (éventuellement déjà calculée).
     void testeCollision(Mobile* mobile, State& state);
-    void testeCollision(const Collision& collision, State& state);
+    void testeCollision(Mobile* mobile, const Time& time, State& state);
+    Time testeCollision(const Collision& collision, State& state);
 
     // Paramètres.
     Coord<double> mPosition;
     Coord<double> mVitesse;
     double mMasse;
+    // Instant auquel correspondent la position et la vitesse.
+    Time mTime;
 
     QColor mColor;
 
 private:
-    // Supprime le mobile de la liste des événements.
-    void detach(State& state);
-    // Ajoute un mobile à la liste des cibles.
-    bool addTarget(Mobile* mobile, State& state, bool addCollision = true);
-
-    // Prochaine(s) collision(s).
+    // Ajoute une collision prévue.
+    void addCandidate(const Time& time, const Collision& collision, State& state);
+    // Indique que l'entrée du mobile dans la table des événements doit être mise à jour.
+    void invalidate(State& state);
+
+    // Collisions prévues (celles avec un autre mobile figurent aussi dans ses prévisions).
+    std::vector<std::pair<Time, Collision> > mCandidates;
+    // Prochain changement de zone, si les collisions ultérieures seront cherchées à ce moment (jamais sinon).
+    Time mHorizon;
+    // Prochain changement de zone, qui borne toujours la recherche des obstacles (ils sont étudiés de nouveau
+    // à chaque changement de zone).
+    Time mSortie;
+    // Entrée unique du mobile dans la table des événements, datée de sa prochaine collision.
     Time mTargetTime;
-    std::set<std::multimap<Time, std::shared_ptr<Event> >::iterator> mNextCollisions;
-    // Graphe des cibles.
-    std::unordered_set<Mobile*> mTargets;
-    std::unordered_set<Mobile*> mAttached;
+    EventQueue::Handle mHandle;
+    bool mDirty;
     // Dernière(s) collision(s).
     Time mLastTime;
-    std::list<std::shared_ptr<Collision> > mLastCollisions;
+    std::vector<Collision> mLastCollisions;
 
-    // Identifiant unique du mobile.
+    // Indice du mobile dans la table de l'état, et type du mobile.
     unsigned int mIndex;
-    static unsigned int index;
+    Type mType;
 };
 
+// Avance le mobile jusqu'à l'instant indiqué, selon la politique de gravité.
+template <typename Politique>
+inline void Mobile::avance(const Time& time, const Coord<double>& gravity)
+{
+    double t = time.time();
+    mPosition.x += mVitesse.x * t + (Politique::horizontale ? gravity.x * t * t / 2 : 0.0);
+    mPosition.y += mVitesse.y * t + (Politique::verticale ? gravity.y * t * t / 2 : 0.0);
+    if (Politique::horizontale)
+        mVitesse.x += gravity.x * t;
+    if (Politique::verticale)
+        mVitesse.y += gravity.y * t;
+}
+
 // Accesseurs.
 inline const Coord<double>& Mobile::position() const
     {return mPosition;}
@@ -143,5 +189,11 @@ inline QColor Mobile::color() const
     {return mColor;}
 inline unsigned int Mobile::id() const
     {return mIndex;}
+inline Mobile::Type Mobile::type() const
+    {return mType;}
+inline double Mobile::vitesseOrigine(const Coord<double>& gravity) const
+    {return mVitesse.y - gravity.y * mTime.time();}
+inline const Time& Mobile::horizon() const
+    {return mHorizon;}
 
 #endif // MOBILE_HPP
@@ -0,0 +1,94 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef PAIRES_HPP
+#define PAIRES_HPP
+
+#include <type_traits>
+#include "boule.hpp"
+#include "piston.hpp"
+
+// Conversion d'un mobile vers son type, parmi une liste de types dont le premier a l'indice donné dans Mobile::Type.
+// Les types sont testés dans l'ordre, le dernier étant choisi sans test.
+template <unsigned int Indice, typename... Types>
+class ConversionMobile;
+
+// Aiguillage des collisions entre mobiles.
+// Chaque mobile est converti vers son type par une suite de tests générée à la compilation (traitée comme un switch
+// par le compilateur) : une paire de types aboutit à un appel direct de son noyau (collision ou doCollision), sans
+// indirection, et les noyaux de prédiction, définis dans les en-têtes des mobiles, sont développés sur place.
+// L'ordre des paramètres du modèle doit suivre celui de l'énumération Mobile::Type.
+template <typename... Types>
+class Paires
+{
+public:
+    // Calcule l'instant de collision entre deux mobiles.
+    static inline Time collision(const Mobile* mobile1, const Mobile* mobile2);
+    // Effectue la collision entre deux mobiles.
+    static inline void doCollision(Mobile* mobile1, Mobile* mobile2, State& state);
+};
+
+// Types de mobiles, dans l'ordre de Mobile::Type.
+// Ajouter un type de mobile revient à l'ajouter ici et à implémenter ses noyaux collision et doCollision.
+typedef Paires<Boule, Piston> PairesMobiles;
+
+
+template <unsigned int Indice, typename M>
+class ConversionMobile<Indice, M>
+{
+public:
+    // Appelle la fonction avec le mobile converti vers son type (en conservant sa constance).
+    template <typename Base, typename Fonction>
+    static inline decltype(auto) applique(Base* mobile, Fonction&& fonction)
+    {
+        typedef typename std::conditional<std::is_const<Base>::value, const M, M>::type Type;
+        return fonction(static_cast<Type*>(mobile));
+    }
+};
+
+template <unsigned int Indice, typename M, typename Suivant, typename... Restants>
+class ConversionMobile<Indice, M, Suivant, Restants...>
+{
+public:
+    // Appelle la fonction avec le mobile converti vers son type (en conservant sa constance).
+    template <typename Base, typename Fonction>
+    static inline decltype(auto) applique(Base* mobile, Fonction&& fonction)
+    {
+        if (mobile->type() == Indice)
+            return ConversionMobile<Indice, M>::applique(mobile, fonction);
+        return ConversionMobile<Indice + 1, Suivant, Restants...>::applique(mobile, fonction);
+    }
+};
+
+template <typename... Types>
+inline Time Paires<Types...>::collision(const Mobile* mobile1, const Mobile* mobile2)
+{
+    return ConversionMobile<0, Types...>::applique(mobile1, [&](auto premier) {
+        return ConversionMobile<0, Types...>::applique(mobile2, [&](auto second) {return premier->collision(second);});
+    });
+}
+
+template <typename... Types>
+inline void Paires<Types...>::doCollision(Mobile* mobile1, Mobile* mobile2, State& state)
+{
+    ConversionMobile<0, Types...>::applique(mobile1, [&](auto premier) {
+        ConversionMobile<0, Types...>::applique(mobile2, [&](auto second) {premier->doCollision(second, state);});
+    });
+}
+
+#endif // PAIRES_HPP
@@ -0,0 +1,83 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "particules.hpp"
+
+// Constructeur.
+Particules::Particules() :
+    x(), y(), vx(), vy(),
+    rayon(), masse(), population(),
+    mX0(), mY0(), mVx0(), mVy0(), mT0()
+{
+}
+
+
+// Vide les tableaux.
+void Particules::clear()
+{
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    rayon.clear();
+    masse.clear();
+    population.clear();
+    mX0.clear();
+    mY0.clear();
+    mVx0.clear();
+    mVy0.clear();
+    mT0.clear();
+}
+
+// Ajoute une particule (renvoie son rang).
+unsigned int Particules::add(const Coord<double>& position, const Coord<double>& vitesse, const Time& time, double r, double m)
+{
+    x.push_back(position.x);
+    y.push_back(position.y);
+    vx.push_back(vitesse.x);
+    vy.push_back(vitesse.y);
+    rayon.push_back(r);
+    masse.push_back(m);
+    population.push_back(0);
+    mX0.push_back(position.x);
+    mY0.push_back(position.y);
+    mVx0.push_back(vitesse.x);
+    mVy0.push_back(vitesse.y);
+    mT0.push_back(time.time());
+    return mT0.size() - 1;
+}
+
+
+// Calcule les positions et vitesses de toutes les particules à l'instant indiqué.
+// Les tableaux sont parcourus sans branchement ni indirection, ce qui permet au compilateur de vectoriser la boucle.
+void Particules::avance(const Time& time, const Coord<double>& gravity)
+{
+    const double t = time.time();
+    const double gx = gravity.x;
+    const double gy = gravity.y;
+    const unsigned int n = this->size();
+
+    for (unsigned int i = 0 ; i < n ; ++i)
+    {
+        double dt = t - mT0[i];
+        x[i] = mX0[i] + mVx0[i] * dt + gx * dt * dt / 2;
+        y[i] = mY0[i] + mVy0[i] * dt + gy * dt * dt / 2;
+        vx[i] = mVx0[i] + gx * dt;
+        vy[i] = mVy0[i] + gy * dt;
+    }
+}
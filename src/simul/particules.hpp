@@ -0,0 +1,90 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef PARTICULES_HPP
+#define PARTICULES_HPP
+
+#include <vector>
+
+#include "coord.hpp"
+#include "time.hpp"
+
+// Copie de l'état cinématique des boules en tableaux contigus (une composante par tableau), indexés par le rang
+// de la boule dans la table de l'état, qui ne sert qu'au dessin et aux mesures.
+// L'état de référence reste celui des objets Boule, qui calculent et effectuent les collisions sans lire ces tableaux :
+// chaque boule y recopie sa trajectoire quand elle change, et les positions à un instant donné sont calculées
+// en une seule boucle vectorisable, sans avancer les objets.
+class Particules
+{
+public:
+    // Constructeur.
+    Particules();
+
+    // Vide les tableaux.
+    void clear();
+    // Ajoute une particule (renvoie son rang).
+    unsigned int add(const Coord<double>& position, const Coord<double>& vitesse, const Time& time, double rayon, double masse);
+    // Enregistre la trajectoire d'une particule (position et vitesse à l'instant indiqué).
+    inline void setTrajectoire(unsigned int rang, const Coord<double>& position, const Coord<double>& vitesse, const Time& time);
+    // Définit la population d'une particule.
+    inline void setPopulation(unsigned int rang, unsigned int population);
+
+    // Calcule les positions et vitesses de toutes les particules à l'instant indiqué.
+    void avance(const Time& time, const Coord<double>& gravity);
+
+    // Accesseurs.
+    inline unsigned int size() const;
+
+    // Positions et vitesses au dernier instant calculé.
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> vx;
+    std::vector<double> vy;
+    // Propriétés.
+    std::vector<double> rayon;
+    std::vector<double> masse;
+    std::vector<unsigned int> population;
+
+private:
+    // Trajectoires : position et vitesse à l'instant mT0.
+    std::vector<double> mX0;
+    std::vector<double> mY0;
+    std::vector<double> mVx0;
+    std::vector<double> mVy0;
+    std::vector<double> mT0;
+};
+
+// Enregistre la trajectoire d'une particule.
+inline void Particules::setTrajectoire(unsigned int rang, const Coord<double>& position, const Coord<double>& vitesse, const Time& time)
+{
+    mX0[rang] = position.x;
+    mY0[rang] = position.y;
+    mVx0[rang] = vitesse.x;
+    mVy0[rang] = vitesse.y;
+    mT0[rang] = time.time();
+}
+
+// Définit la population d'une particule.
+inline void Particules::setPopulation(unsigned int rang, unsigned int value)
+    {population[rang] = value;}
+
+// Accesseurs.
+inline unsigned int Particules::size() const
+    {return mT0.size();}
+
+#endif // PARTICULES_HPP
@@ -18,109 +18,51 @@
 
 #include "piston.hpp"
 
+#include <algorithm>
 #include "state.hpp"
-#include "solveur.hpp"
 
 // Constructeur.
 Piston::Piston(ConfigPiston config, State& state) :
-    Mobile(Coord<double>(0, config.mPosition), Coord<double>(0, config.mVitesse), config.mColor, config.mMasse),
+    Mobile(_piston, Coord<double>(0, config.mPosition), Coord<double>(0, config.mVitesse), config.mColor, config.mMasse, state),
     mEpaisseur(config.mEpaisseur),
-    mArea1(std::floor(mPosition.y / state.sizeArea)),
-    mArea2(std::floor((mPosition.y + mEpaisseur) / state.sizeArea))
+    mArea1(std::floor(mPosition.y / state.grilles.front().sizeArea())),
+    mArea2(std::floor((mPosition.y + mEpaisseur) / state.grilles.front().sizeArea()))
 {
-    // Mise à jour de la carte.
-    auto& pistons1 = state.mapMobiles[mArea1].pistons();
-    pistons1.prepend(this);
-    mMapIt1 = pistons1.begin();
-
-    auto& pistons2 = state.mapMobiles[mArea2].pistons();
-    pistons2.prepend(this);
-    mMapIt2 = pistons2.begin();
+    this->attachArea(state);
 }
 
 
-// Calcule l'instant de la prochaine collision avec le mobile.
-Time Piston::collision(const Mobile* mobile) const
-{
-    return mobile->collision(this);
-}
-
-Time Piston::collision(const Boule* boule) const
-{
-    return boule->collision(this);
-}
-
-Time Piston::collision(const Piston* piston) const
-{
-    // Différence de vitesse.
-    double dVitesseY = mVitesse.y - piston->mVitesse.y;
-    double dPositionY = mPosition.y - piston->mPosition.y;
-
-    // Différence de position.
-    if (dPositionY >= 0)
-        dPositionY -= piston->mEpaisseur;
-    else
-        dPositionY += mEpaisseur;
-
-    // Calcul de l'instant.
-    return Time(dPositionY / dVitesseY);
-}
-
-// Calcule l'instant du prochain changement de zone.
-Time Piston::newArea(double sizeArea, const Coord<double>& gravity) const
+// Instant où l'une des faces du piston sort de sa ligne, selon la politique de gravité.
+template <typename Politique>
+Time Piston::sortieZone(Politique, const State& state) const
 {
+    double sizeArea = state.grilles.front().sizeArea();
+    double gravity = state.config.gravity().y;
     Time result;
     Time tmp;
 
-    // Résolution selon le signe de la gravité.
-    if (gravity.y == 0.0)
+    if (Politique::verticale)
     {
-        if (mVitesse.y > 0)
-        {
-            result = ((mArea1 + 1) * sizeArea - mPosition.y) / mVitesse.y;
-            tmp = ((mArea2 + 1) * sizeArea - mPosition.y - mEpaisseur) / mVitesse.y;
-        }
-        else if (mVitesse.y < 0)
-        {
-            result = (mArea1 * sizeArea - mPosition.y) / mVitesse.y;
-            tmp = (mArea2 * sizeArea - mPosition.y - mEpaisseur) / mVitesse.y;
-        }
+        result = Gravite::sortie(mPosition.y, mVitesse.y, gravity, mArea1 * sizeArea, (mArea1 + 1) * sizeArea);
+        tmp = Gravite::sortie(mPosition.y + mEpaisseur, mVitesse.y, gravity, mArea2 * sizeArea, (mArea2 + 1) * sizeArea);
     }
-    else if (gravity.y < 0.0)
-    {
-        result = Solveur::fstQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y - (mArea1 + 1) * sizeArea);
-        tmp = Solveur::sndQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y - mArea1 * sizeArea);
-        if (tmp < result)
-            result = tmp;
-        tmp = Solveur::fstQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y + mEpaisseur - (mArea2 + 1) * sizeArea);
-        if (tmp < result)
-            result = tmp;
-        tmp = Solveur::sndQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y + mEpaisseur - mArea2 * sizeArea);
-    }
-    else if (gravity.y > 0.0)
+    else
     {
-        result = Solveur::sndQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y - (mArea1 + 1) * sizeArea);
-        tmp = Solveur::fstQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y - mArea1 * sizeArea);
-        if (tmp < result)
-            result = tmp;
-        tmp = Solveur::sndQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y + mEpaisseur - (mArea2 + 1) * sizeArea);
-        if (tmp < result)
-            result = tmp;
-        tmp = Solveur::fstQuadratique(gravity.y / 2.0, mVitesse.y, mPosition.y + mEpaisseur - mArea2 * sizeArea);
+        result = Gravite::sortie(mPosition.y, mVitesse.y, mArea1 * sizeArea, (mArea1 + 1) * sizeArea);
+        tmp = Gravite::sortie(mPosition.y + mEpaisseur, mVitesse.y, mArea2 * sizeArea, (mArea2 + 1) * sizeArea);
     }
-    if (tmp < result)
-        result = tmp;
 
-    return result;
+    return tmp < result ? tmp : result;
 }
 
-
-// Effectue la collision avec le mobile.
-void Piston::doCollision(Mobile* mobile, State& state)
+// Calcule l'instant du prochain changement de zone.
+Time Piston::newArea(const State& state) const
 {
-    mobile->doCollision(this, state);
+    return Gravite::applique(state.gravite, [&](auto politique) {return this->sortieZone(politique, state);});
 }
 
+
+// Effectue la collision avec le mobile.
 // Collision avec une boule.
 void Piston::doCollision(Boule* boule, State& state)
 {
@@ -154,63 +96,134 @@ void Piston::doCollision(Piston* piston, State& state)
 // Effectue un changement de zone.
 void Piston::changeArea(State& state)
 {
-    state.mapMobiles[mArea1].pistons().erase(mMapIt1);
-    state.mapMobiles[mArea2].pistons().erase(mMapIt2);
+    this->detachArea(state);
 
     // Calcul des zones.
     if (mVitesse.y >= 0)
     {
-        mArea1 = std::floor(mPosition.y / state.sizeArea + 0.5);
-        mArea2 = std::floor((mPosition.y + mEpaisseur) / state.sizeArea + 0.5);
+        mArea1 = std::floor(mPosition.y / state.grilles.front().sizeArea() + 0.5);
+        mArea2 = std::floor((mPosition.y + mEpaisseur) / state.grilles.front().sizeArea() + 0.5);
     }
     else
     {
-        mArea1 = std::floor(mPosition.y / state.sizeArea - 0.5);
-        mArea2 = std::floor((mPosition.y + mEpaisseur) / state.sizeArea - 0.5);
+        mArea1 = std::floor(mPosition.y / state.grilles.front().sizeArea() - 0.5);
+        mArea2 = std::floor((mPosition.y + mEpaisseur) / state.grilles.front().sizeArea() - 0.5);
     }
 
-    // Mise à jour de la carte.
-    auto& pistons1 = state.mapMobiles[mArea1].pistons();
-    pistons1.prepend(this);
-    mMapIt1 = pistons1.begin();
-
-    auto& pistons2 = state.mapMobiles[mArea2].pistons();
-    pistons2.prepend(this);
-    mMapIt2 = pistons2.begin();
-
+    this->attachArea(state);
     this->updateRefresh(state);
 }
 
+// Replace le piston dans les lignes de sa position actuelle, après reconstruction des grilles.
+void Piston::resetArea(State& state)
+{
+    double sizeArea = state.grilles.front().sizeArea();
+    mArea1 = std::floor(mPosition.y / sizeArea);
+    mArea2 = std::floor((mPosition.y + mEpaisseur) / sizeArea);
+    this->attachArea(state);
+}
+
 
-// Cherche des collisions avec des mobiles.
+// Cherche des collisions avec des mobiles, sur les lignes voisines de celles des deux faces du piston
+// (parcourues une seule fois lorsqu'elles se recouvrent ou se touchent).
 void Piston::updateCollisionsMobiles(State& state)
 {
-    // Vérifie les mobiles des zones voisines.
-    for (int j = mArea1 - 1 ; j <= mArea1 + 1 ; ++j)
+    if (mArea2 - mArea1 <= 3)
+        this->updateCollisionsMobiles(mArea1 - 1, mArea2 + 1, state);
+    else
+    {
+        this->updateCollisionsMobiles(mArea1 - 1, mArea1 + 1, state);
+        this->updateCollisionsMobiles(mArea2 - 1, mArea2 + 1, state);
+    }
+}
+
+// Cherche des collisions avec les mobiles des lignes [debut, fin] de la grille de référence.
+void Piston::updateCollisionsMobiles(int debut, int fin, State& state)
+{
+    // Vérifie les boules de chaque grille, sur les lignes couvrant celles de la grille de référence.
+    // Les lignes répertorient directement leurs boules, triées par vitesse verticale ramenée à l'origine des temps
+    // (la vitesse relative au piston ne change pas d'ici la prochaine collision) : sous le piston, seules les boules
+    // plus rapides que lui peuvent l'atteindre, et au-dessus seules les plus lentes. Le parcours d'une ligne
+    // entièrement d'un côté s'arrête donc à la vitesse du piston (à l'erreur d'arrondi près).
+    // Le contact (d'une seule coordonnée) est ensuite calculé sur place : seules les boules atteintes avant
+    // l'horizon sont ajoutées aux prévisions.
+    double sizeArea = state.grilles.front().sizeArea();
+    double vitesse = this->vitesseOrigine(state.config.gravity());
+    double arrondi = 1e-9 * (1.0 + std::fabs(vitesse) + std::fabs(mVitesse.y));
+    for (auto& grille : state.grilles)
+    {
+        // Les centres peuvent dépasser de leur ligne de la peau (listes de voisins), et d'un rayon par sécurité.
+        double marge = grille.rayon() + (state.recherche == State::_voisins ? grille.peau() : 0.0);
+        int premiere = std::floor(debut * sizeArea / grille.sizeArea());
+        int derniere = std::ceil((fin + 1) * sizeArea / grille.sizeArea()) - 1;
+        for (int j = premiere ; j <= derniere ; ++j)
+        {
+            const std::vector<Boule*>* boules = grille.findBoules(j);
+            if (!boules)
+                continue;
+
+            auto first = boules->begin();
+            auto last = boules->end();
+            if ((j + 1) * grille.sizeArea() + marge < mPosition.y)
+                first = std::lower_bound(first, last, vitesse - arrondi,
+                                         [](const Boule* boule, double cle) {return boule->cleLigne() < cle;});
+            else if (j * grille.sizeArea() - marge > mPosition.y)
+                last = std::upper_bound(first, last, vitesse + arrondi,
+                                        [](double cle, const Boule* boule) {return cle < boule->cleLigne();});
+
+            for (auto it = first ; it != last ; ++it)
+                this->testeBoule(*it, state);
+        }
+    }
+
+    // Vérifie les pistons.
+    for (int j = debut ; j <= fin ; ++j)
     {
-        // Vérifie les boules.
-        for (auto& boule : state.mapMobiles[j].boules())
-            this->testeCollision(boule, state);
-
-        // Vérifie les pistons.
-        for (auto& piston : state.mapMobiles[j].pistons())
-            if (piston != this)
-                this->testeCollision(piston, state);
+        const std::vector<Piston*>* pistons = state.grilles.front().findPistons(j);
+        if (pistons)
+            for (auto& piston : *pistons)
+                if (piston != this)
+                    this->testeCollision(piston, state);
     }
+}
 
-    // Vérifie les mobiles des zones voisines.
-    for (int j = mArea2 - 1 ; j <= mArea2 + 1 ; ++j)
+// Teste la collision avec la boule, écartée si elle n'est pas atteinte avant l'horizon (mobiles qui s'éloignent,
+// ou trop lents). L'instant calculé ici est directement ajouté aux prévisions.
+void Piston::testeBoule(Boule* boule, State& state)
+{
+    // La collision a déjà été étudiée par la boule.
+    if (this->isCandidate(Collision(Collision::_mobiles, this->id(), boule->id())))
+        return;
+
+    ++state.countEtudes.total;
+    boule->synchronize(state);
+    Time time = state.now + boule->collision(this);
+    if (time.isNever() || this->horizon() < time)
     {
-        // Vérifie les boules.
-        for (auto& boule : state.mapMobiles[j].boules())
-            this->testeCollision(boule, state);
-
-        // Vérifie les pistons.
-        for (auto& piston : state.mapMobiles[j].pistons())
-            if (piston != this)
-                this->testeCollision(piston, state);
+        ++state.countEtudes.ecartees;
+        return;
     }
 
-    // Vérifie un changement de zone.
-    this->testeCollision(Collision(this), state);
+    ++state.countEtudes.mobiles;
+    this->testeCollision(boule, time, state);
+}
+
+
+// Ajoute le piston aux lignes de ses zones.
+void Piston::attachArea(State& state)
+{
+    state.grilles.front().pistons(mArea1).push_back(this);
+    state.grilles.front().pistons(mArea2).push_back(this);
+}
+
+// Enlève le piston des lignes de ses zones.
+void Piston::detachArea(State& state)
+{
+    for (int area : {mArea1, mArea2})
+    {
+        std::vector<Piston*>& pistons = state.grilles.front().pistons(area);
+        auto it = std::find(pistons.begin(), pistons.end(), this);
+        *it = pistons.back();
+        pistons.pop_back();
+    }
 }
@@ -20,6 +20,7 @@
 #define PISTON_HPP
 
 #include "mobile.hpp"
+#include "boule.hpp"
 #include "config_piston.hpp"
 
 // Mobile décrivant un piston horizontal.
@@ -34,33 +35,88 @@ public:
     // Accesseurs.
     inline double epaisseur() const;
 
-    // Calcule l'instant de la prochaine collision avec le mobile.
-    Time collision(const Mobile* mobile) const;
-    Time collision(const Boule* boule) const;
-    Time collision(const Piston* piston) const;
+    // Calcule l'instant de la prochaine collision avec le mobile (noyaux des paires, appelés directement par Paires).
+    inline Time collision(const Boule* boule) const;
+    inline Time collision(const Piston* piston) const;
     // Calcule l'instant du prochain changement de zone.
-    Time newArea(double sizeArea, const Coord<double>& gravity) const;
+    Time newArea(const State& state) const;
 
     // Effectue la collision avec le mobile.
-    void doCollision(Mobile* mobile, State& state);
     void doCollision(Boule* boule, State& state);
     void doCollision(Piston* piston, State& state);
     void changeArea(State& state);
+    // Replace le piston dans les lignes de sa position actuelle, après reconstruction des grilles.
+    void resetArea(State& state);
 
 private:
     // Cherche des collisions avec des mobiles.
     void updateCollisionsMobiles(State& state);
+    // Cherche des collisions avec les mobiles des lignes [debut, fin] de la grille de référence.
+    void updateCollisionsMobiles(int debut, int fin, State& state);
+    // Teste la collision avec la boule (calculée une seule fois), écartée d'emblée si elle n'est pas atteinte
+    // avant l'horizon.
+    void testeBoule(Boule* boule, State& state);
+    // Instant où l'une des faces du piston sort de sa ligne, selon la politique de gravité.
+    template <typename Politique>
+    Time sortieZone(Politique politique, const State& state) const;
+
+    // Ajoute ou enlève le piston des lignes de ses zones.
+    void attachArea(State& state);
+    void detachArea(State& state);
 
     // Propriétés géométriques.
     double mEpaisseur;
     int mArea1;
     int mArea2;
-    QList<Piston*>::iterator mMapIt1;
-    QList<Piston*>::iterator mMapIt2;
 };
 
 // Accesseurs.
 inline double Piston::epaisseur() const
     {return mEpaisseur;}
 
+// Calcule l'instant de la prochaine collision avec le mobile.
+// Collision avec une boule.
+inline Time Piston::collision(const Boule* boule) const
+{
+    return boule->collision(this);
+}
+
+// Collision avec un piston.
+inline Time Piston::collision(const Piston* piston) const
+{
+    // Différence de vitesse.
+    double dVitesseY = mVitesse.y - piston->mVitesse.y;
+    double dPositionY = mPosition.y - piston->mPosition.y;
+
+    // Différence de position.
+    if (dPositionY >= 0)
+        dPositionY -= piston->mEpaisseur;
+    else
+        dPositionY += mEpaisseur;
+
+    // Calcul de l'instant.
+    return Time(dPositionY / dVitesseY);
+}
+
+// Calcule l'instant de la prochaine collision de la boule avec le piston (défini ici, où le piston est connu).
+inline Time Boule::collision(const Piston* piston) const
+{
+    // Différence de vitesse.
+    double dVitesseY = piston->mVitesse.y - mVitesse.y;
+    double dPositionY = mPosition.y - piston->mPosition.y;
+
+    // Les mobiles s'éloignent.
+    if (dVitesseY * dPositionY < 0.0)
+        return Time();
+
+    // Différence de position.
+    if (dPositionY >= 0.0)
+        dPositionY -= (mRayon + piston->epaisseur());
+    else
+        dPositionY += mRayon;
+
+    // Calcul de l'instant.
+    return Time(dPositionY / dVitesseY);
+}
+
 #endif // PISTON_HPP
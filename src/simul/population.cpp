@@ -24,6 +24,7 @@
 #include "state.hpp"
 
 // Génère une population de boules selon la configuration.
+// Les boules sont seulement placées : leurs premières collisions sont cherchées ensuite, une fois toutes placées.
 void Population::create(unsigned int index, State& state)
 {
     if (!mConfig.mTaille)
@@ -40,14 +41,14 @@ void Population::create(unsigned int index, State& state)
         Coord<double> pos;
 
         do
-            pos = Coord<double>(distribX(Solveur::generateur), distribY(Solveur::generateur));
+            pos = Coord<double>(distribX(state.generateur), distribY(state.generateur));
         while (this->invalid(pos, state));
 
         // Ajoute une boule.
         std::unique_ptr<Boule> boule = std::make_unique<Boule>(
                     pos,
-                    Coord<double>(distribVitesse(Solveur::generateur),
-                                  distribVitesse(Solveur::generateur)),
+                    Coord<double>(distribVitesse(state.generateur),
+                                  distribVitesse(state.generateur)),
                     mConfig.mColor,
                     mConfig.mMasse,
                     mConfig.mRayon,
@@ -55,7 +56,6 @@ void Population::create(unsigned int index, State& state)
         state.boules.push_back(std::move(boule));
 
         state.boules.back()->setPopulation(index, state);
-        state.boules.back()->updateCollisions(state);
     }
 }
 
@@ -84,10 +84,28 @@ bool Population::invalid(const Coord<double>& pos, State& state)
          && (pos.y - piston->position().y) <= mConfig.mRayon + piston->epaisseur())
             return true;
 
-    // Vérifie les intersections avec les autres boules.
-    for (auto& boule : state.boules)
-        if ((boule->position() - pos).length() <= mConfig.mRayon + boule->rayon())
-            return true;
+    // Vérifie les intersections avec les autres boules, dans les cases à portée de chaque grille
+    // (les boules déjà placées sont répertoriées dans la case de leur position).
+    for (auto& grille : state.grilles)
+    {
+        double portee = mConfig.mRayon + grille.rayon();
+        Coord<int> debut = grille.area(Coord<double>(pos.x - portee, pos.y - portee));
+        Coord<int> fin = grille.area(Coord<double>(pos.x + portee, pos.y + portee));
+
+        for (int j = debut.y ; j <= fin.y ; ++j)
+        {
+            for (int i = debut.x ; i <= fin.x ; ++i)
+            {
+                const Grille::Cell* cell = grille.find(Coord<int>(i, j));
+                if (!cell)
+                    continue;
+
+                for (auto& boule : cell->mBoules)
+                    if ((boule->position() - pos).length() <= mConfig.mRayon + boule->rayon())
+                        return true;
+            }
+        }
+    }
 
     return false;
 }
@@ -0,0 +1,51 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include "scheduler.hpp"
+
+#include "heap_scheduler.hpp"
+#include "calendar_scheduler.hpp"
+
+// Fonction enveloppant les ordonnanceurs créés.
+Scheduler::Enveloppe Scheduler::enveloppe = nullptr;
+
+// Crée un ordonnanceur du type demandé.
+std::unique_ptr<Scheduler> Scheduler::create(Type type)
+{
+    std::unique_ptr<Scheduler> scheduler;
+    if (type == _calendar)
+        scheduler = std::make_unique<CalendarScheduler>();
+    else
+        scheduler = std::make_unique<HeapScheduler>();
+
+    if (enveloppe)
+        return enveloppe(std::move(scheduler));
+    return scheduler;
+}
+
+// Destructeur.
+Scheduler::~Scheduler()
+{
+}
+
+// Ajoute des événements en bloc (un par un, sauf si l'ordonnanceur sait mieux faire).
+void Scheduler::pushAll(const std::vector<std::pair<Handle, Time> >& events)
+{
+    for (auto& event : events)
+        this->push(event.first, event.second);
+}
@@ -0,0 +1,71 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "time.hpp"
+
+// Interface des structures ordonnant les événements d'une EventQueue.
+// Un ordonnanceur ne manipule que des identifiants d'événements et leurs dates.
+class Scheduler
+{
+public:
+    enum Type
+    {
+        _heap = 0, _calendar = 1
+    };
+
+    // Identifiant d'un événement.
+    typedef unsigned int Handle;
+
+    // Crée un ordonnanceur du type demandé.
+    static std::unique_ptr<Scheduler> create(Type type);
+
+    // Fonction recevant chaque ordonnanceur créé, qui peut l'envelopper pour l'instrumenter
+    // (aucune par défaut ; le programme de mesure bench/ s'en sert pour enregistrer les opérations).
+    typedef std::unique_ptr<Scheduler> (*Enveloppe)(std::unique_ptr<Scheduler> scheduler);
+    static Enveloppe enveloppe;
+
+    // Destructeur.
+    virtual ~Scheduler();
+
+    // Vide la structure.
+    virtual void clear() = 0;
+
+    // Ajoute un événement (qui ne doit pas être présent).
+    virtual void push(Handle handle, const Time& time) = 0;
+    // Ajoute des événements en bloc (aucun ne doit être présent).
+    virtual void pushAll(const std::vector<std::pair<Handle, Time> >& events);
+    // Change la date d'un événement présent.
+    virtual void update(Handle handle, const Time& time) = 0;
+    // Retire un événement présent.
+    virtual void remove(Handle handle) = 0;
+
+    // Indique si l'événement est présent.
+    virtual bool contains(Handle handle) const = 0;
+    // Nombre d'événements présents.
+    virtual unsigned int size() const = 0;
+    // Prochain événement (la structure ne doit pas être vide).
+    virtual Handle top() = 0;
+};
+
+#endif // SCHEDULER_HPP
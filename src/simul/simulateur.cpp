@@ -19,7 +19,7 @@
 #include "simulateur.hpp"
 
 #include <QPainter>
-#include <QCoreApplication>
+#include <QElapsedTimer>
 #include "coord_io.tpl"
 
 // Constructeur.
@@ -32,12 +32,22 @@ Simulateur::Simulateur(const Configuration& config) :
     mSliderValues(new QSlider(Qt::Horizontal)),
     mLabelCourbes(new QLabel("display frequency :")),
     mSliderCourbes(new QSlider(Qt::Horizontal)),
-    mState(config)
+    mLabelScheduler(new QLabel("event queue :")),
+    mComboScheduler(new QComboBox),
+    mLabelRecherche(new QLabel("neighbour search :")),
+    mComboRecherche(new QComboBox),
+    mCourbesPending(false),
+    mState(config),
+    mInstantanes()
 {
     // Création de l'interface graphique.
     mSliderVitesse->setRange(-1000, 250);
     mSliderValues->setRange(-500, 500);
     mSliderCourbes->setRange(-750, 250);
+    mComboScheduler->addItem("heap");
+    mComboScheduler->addItem("calendar queue");
+    mComboRecherche->addItem("cell grid");
+    mComboRecherche->addItem("neighbour lists");
 
     mLayout->setMargin(0);
     mLayout->addWidget(mGroupCourbes, 0, 0, 1, 2);
@@ -47,11 +57,17 @@ Simulateur::Simulateur(const Configuration& config) :
     mLayout->addWidget(mSliderValues, 2, 1);
     mLayout->addWidget(mLabelCourbes, 3, 0);
     mLayout->addWidget(mSliderCourbes, 3, 1);
+    mLayout->addWidget(mLabelScheduler, 4, 0);
+    mLayout->addWidget(mComboScheduler, 4, 1);
+    mLayout->addWidget(mLabelRecherche, 5, 0);
+    mLayout->addWidget(mComboRecherche, 5, 1);
 
     // Connexion des signaux et slots.
     QObject::connect(mSliderVitesse, SIGNAL(valueChanged(int)), this, SLOT(setVitesse(int)));
     QObject::connect(mSliderValues, SIGNAL(valueChanged(int)), this, SLOT(setValues(int)));
     QObject::connect(mSliderCourbes, SIGNAL(valueChanged(int)), this, SLOT(setCourbes(int)));
+    QObject::connect(mComboScheduler, SIGNAL(activated(int)), this, SLOT(setScheduler(int)));
+    QObject::connect(mComboRecherche, SIGNAL(activated(int)), this, SLOT(setRecherche(int)));
 
     // Initialisation.
     mSliderVitesse->setValue(-500);
@@ -85,56 +101,85 @@ void Simulateur::doRestart()
     this->addCourbeEvent();
 
     // Redessine l'espace.
+    mMesuresPending.clear();
+    mCourbesPending = false;
+    this->publishDrawing();
     emit fullDraw();
 }
 
-// Avance jusqu'au prochain événement de dessin.
-void Simulateur::playToNextDraw()
+// Avance jusqu'au prochain événement de dessin, sans dépasser le temps de calcul accordé.
+// La tranche s'arrête entre deux dates d'événements, la simulation restant cohérente.
+// Aucun widget n'est touché ici : les mises à jour sont transmises ensuite par refreshView() et refreshDrawing().
+bool Simulateur::playSlice(int msec)
 {
-    while (!this->playNext());
+    QElapsedTimer timer;
+    timer.start();
+
+    while (!this->playNext())
+        if (timer.elapsed() >= msec)
+            return false;
+    return true;
+}
+
+// Transmet à l'interface graphique les mises à jour en attente (courbes, statut).
+void Simulateur::refreshView()
+{
+    if (!mStatusText.isEmpty())
+    {
+        emit statusText(mStatusText);
+        mStatusText.clear();
+    }
+
+    for (auto& mesure : mMesuresPending)
+        mGroupCourbes->push(mesure);
+    mMesuresPending.clear();
+
+    if (mCourbesPending)
+    {
+        mGroupCourbes->update();
+        mCourbesPending = false;
+    }
+}
+
+// Redessine le dernier instantané publié s'il est nouveau.
+// Seul l'instantané est lu : la simulation peut continuer pendant le dessin.
+void Simulateur::refreshDrawing()
+{
+    if (mInstantanes.nouveau())
+        emit draw();
 }
 
 // Avance jusqu'au prochain événement et effectue tous les événements de cette date.
 bool Simulateur::playNext()
 {
     // Avance jusqu'au prochain événement.
-    Time timeEvent = mState.events.begin()->first;
+    Time timeEvent = mState.events.time(mState.events.top());
     this->avance(timeEvent);
 
-    //*
+    // Effectue tous les événements de cette date (ils restent enregistrés jusqu'à leur suppression).
     bool isDraw = false;
-    for (auto it = mState.events.begin() ; it != mState.events.end() && it->first == mState.now ; ++it)
-        if (it->second->perform(*this, isDraw))
-            mState.drawingsRefresh.push_back(it);
-    /*/
-    unsigned int count = 0;
-    unsigned int countChocs = 0;
-    for (auto it = mEvents.begin() ; it != mEvents.end() && it->first == mNow ; ++it, ++count)
+    while (!mState.events.empty() && mState.events.time(mState.events.top()) == mState.now)
     {
-        ++countChocs;
-        if (it->second->perform(*this))
-        {
-            mDrawingsRefresh.push_back(it);
-            --countChocs;
-        }
-    }
+        EventQueue::Handle handle = mState.events.top();
+        mState.events.pop();
 
-    if (countChocs > 1)
-        std::cout << "Plusieurs collisions simultanées !" << std::endl;
-    if (count > 1)
-        std::cout << "Plusieurs dessins simultanés !" << std::endl;
-        //QMessageBox::warning(this, "warning", "Several simultaneous collisions !");
-    //*/
+        Event event = mState.events.event(handle);
+        if (event.perform(*this, isDraw))
+            mState.drawingsRefresh.push_back(handle);
+    }
 
     // Met à jour les événements de collisions et de dessin.
     this->refreshCollisions();
     this->refreshDrawings();
 
+    // Déplace l'origine des temps si nécessaire (toutes les dates prévues sont alors à jour).
+    mState.recale();
+
     return isDraw;
 }
 
 
-// Dessine l'état actuel de la simulation.
+// Dessine le dernier instantané publié de la simulation.
 void Simulateur::draw(QPainter& painter, double width)
 {
     painter.setRenderHint(QPainter::Antialiasing);
@@ -146,28 +191,27 @@ void Simulateur::draw(QPainter& painter, double width)
     QPointF left = inverted.map(QPointF(0, 0));
     QPointF right = inverted.map(QPointF(width, 0));
 
-    // Dessin des pistons.
-    for (auto& piston : mState.pistons)
-    {
-        painter.setBrush(piston->color());
-        painter.drawRect(QRectF(left.x(), piston->position().y, right.x() - left.x(), piston->epaisseur()));
-    }
-
-    // Dessin des populations.
-    for (auto& boule : mState.boules)
-    {
-        painter.setBrush(boule->color());
-        painter.drawEllipse(QRectF(boule->position().x - boule->rayon(), boule->position().y - boule->rayon(), 2 * boule->rayon(), 2 * boule->rayon()));
-    }
+    mInstantanes.lecture().draw(painter, left.x(), right.x());
 }
 
 
 // Effectue une collision.
-bool Simulateur::performCollision(Collision& collision)
+bool Simulateur::performCollision(const Collision& collision)
 {
     collision.doCollision(mState);
     if (collision.isReal())
         ++mState.countChocs;
+    else
+        ++mState.countZones;
+    return false;
+}
+
+// Effectue les collisions d'un mobile prévues à cet instant.
+bool Simulateur::performMobileEvent(unsigned int index)
+{
+    Collision collision;
+    while (mState.mobiles[index]->nextCollision(collision, mState))
+        this->performCollision(collision);
     return false;
 }
 
@@ -176,37 +220,36 @@ bool Simulateur::performDrawEvent()
 {
     auto& frames = mState.frames;
     if ((!frames.empty()) && frames.front().first.elapsed() >= 2000)
-        this->emitStatusText(frames.front().first.elapsed(), frames.size(), mState.countChocs - frames.front().second, mState.countChocs);
+        this->makeStatusText(frames.front().first.elapsed(), frames.size(), mState.countChocs - frames.front().second, mState.countChocs);
     while ((!frames.empty()) && frames.front().first.elapsed() >= 2000)
         frames.pop_front();
 
     frames.push_back(std::make_pair(QTime(), mState.countChocs));
     frames.back().first.start();
 
-    emit draw();
-    QCoreApplication::processEvents();
-
+    this->publishDrawing();
     return true;
 }
 
-// Met à jour les valeurs des courbes.
+// Mesure les valeurs des courbes, ajoutées ensuite par refreshView().
 bool Simulateur::performValueEvent()
 {
-    mGroupCourbes->push(mState);
+    mState.updateView();
+    mMesuresPending.append(mGroupCourbes->mesure(mState));
     return true;
 }
 
 // Met à jour les courbes.
 bool Simulateur::performCourbeEvent()
 {
-    mGroupCourbes->update();
+    mCourbesPending = true;
     return true;
 }
 
 // Change la boule de population.
-bool Simulateur::performBouleEvent(Boule* boule)
+bool Simulateur::performBouleEvent(unsigned int index)
 {
-    boule->changePopulation(mState);
+    static_cast<Boule*>(mState.mobiles[index])->changePopulation(mState);
     return false;
 }
 
@@ -214,29 +257,17 @@ bool Simulateur::performBouleEvent(Boule* boule)
 // Ajoute un événement.
 void Simulateur::addDrawEvent()
 {
-    mState.events.insert(
-                std::make_pair(
-                    mState.now + mState.stepDraw,
-                    std::make_shared<DrawEvent>()
-                ));
+    mState.events.insert(mState.now + mState.stepDraw, Event(Event::_draw));
 }
 
 void Simulateur::addValueEvent()
 {
-    mState.events.insert(
-                std::make_pair(
-                    mState.now + mState.stepValues,
-                    std::make_shared<ValueEvent>()
-                ));
+    mState.events.insert(mState.now + mState.stepValues, Event(Event::_value));
 }
 
 void Simulateur::addCourbeEvent()
 {
-    mState.events.insert(
-                std::make_pair(
-                    mState.now + mState.stepCourbes,
-                    std::make_shared<CourbeEvent>()
-                ));
+    mState.events.insert(mState.now + mState.stepCourbes, Event(Event::_courbe));
 }
 
 
@@ -258,11 +289,24 @@ void Simulateur::setCourbes(int value)
     mState.stepCourbes = std::pow(10, -value / 250.0);
 }
 
+// Change la structure ordonnant les événements.
+void Simulateur::setScheduler(int index)
+{
+    mState.events.setScheduler(index == Scheduler::_calendar ? Scheduler::_calendar : Scheduler::_heap);
+}
+
+// Change la recherche des collisions entre boules.
+void Simulateur::setRecherche(int index)
+{
+    mState.setRecherche(index == State::_voisins ? State::_voisins : State::_cases);
+    this->refreshCollisions();
+}
+
 
 // Génère un texte pour la barre de statut (images par seconde, etc).
-void Simulateur::emitStatusText(unsigned int msec, unsigned int frames, unsigned int chocs, unsigned int chocsTotal)
+void Simulateur::makeStatusText(unsigned int msec, unsigned int frames, unsigned int chocs, unsigned int chocsTotal)
 {
-    mState.totalEtudes += mState.countEtudes.first;
+    mState.totalEtudes += mState.countEtudes.total;
 
     double fps = 1000.0 * frames / msec;
     unsigned int cps = 1000 * chocs / msec;/*
@@ -273,47 +317,61 @@ void Simulateur::emitStatusText(unsigned int msec, unsigned int frames, unsigned
     unsigned int spe = 100 * (double)mCountEtudes.second / mTotalEtudes;
     //*/
 
-    mState.countEtudes.first = 0;
+    // Part des études de collisions écartées sans résolution d'équation.
+    unsigned int ecartees = mState.countEtudes.total ? 100.0 * mState.countEtudes.ecartees / mState.countEtudes.total : 0;
+    mState.countEtudes.total = 0;
+    mState.countEtudes.ecartees = 0;
+
+    // Part des événements sans collision réelle (changements de zone).
+    unsigned int zones = mState.countZones ? 100.0 * mState.countZones / (mState.countZones + chocsTotal) : 0;
+
+    // Cas dégénérés (contacts rasants et collisions répétées) depuis le début.
+    unsigned int degeneres = mState.countDegeneres.rasantes + mState.countDegeneres.repetees;
 
-    // Envoie le texte.
-    emit statusText(QString::number((unsigned int)fps) + " frames per second ; " + QString::number(cps) + " collisions per second ; " + QString::number(chocsTotal) + " collisions in total");
+    // Enregistre le texte, envoyé par refreshView().
+    mStatusText = QString::number((unsigned int)fps) + " frames per second ; " + QString::number(cps) + " collisions per second ; " + QString::number(chocsTotal) + " collisions in total ; " + QString::number(zones) + "% non-physical events ; " + QString::number(ecartees) + "% tests culled ; " + QString::number(degeneres) + " degenerate contacts";
 }
 
 
 // Met à jour les collisions en partant des mobiles concernés par la(les) dernière(s) effectuée(s).
 void Simulateur::refreshCollisions()
 {
-    for (auto it = mState.toRefresh.begin() ; it != mState.toRefresh.end() ; ++it)
-        (*it)->updateCollisions(mState);
+    // Tous les mobiles sont détachés avant d'être recalculés, pour que chaque paire ne soit étudiée qu'une fois.
+    for (auto& mobile : mState.toRefresh)
+        mobile->detach(mState);
+    for (auto& mobile : mState.toRefresh)
+        mobile->updateCollisions(mState);
     mState.toRefresh.clear();
+
+    mState.schedule();
 }
 
 // Met à jour les événements de dessin (supprime ceux qui viennent d'être effectués).
 void Simulateur::refreshDrawings()
 {
-    for (auto it = mState.drawingsRefresh.begin() ; it != mState.drawingsRefresh.end() ; ++it)
+    for (auto& handle : mState.drawingsRefresh)
     {
-        (*it)->second->addEvent(*this);
-        mState.events.erase(*it);
+        mState.events.event(handle).addEvent(*this);
+        mState.events.erase(handle);
     }
 
     mState.drawingsRefresh.clear();
 }
 
 
-// Avance la simulation à un instant donné.
-void Simulateur::avance(const Time& time)
+// Publie un instantané de l'état présent pour le dessin.
+void Simulateur::publishDrawing()
 {
-    Time diff = time - mState.now;
-
-    // Avance les populations de boules.
-    for (auto& boule : mState.boules)
-        boule->avance(diff, mState.config.gravity());
+    mState.updateView();
+    mInstantanes.ecriture().copie(mState);
+    mInstantanes.publie();
+}
 
-    // Avance les populations de pistons.
-    for (auto& piston : mState.pistons)
-        piston->avance(diff, mState.config.gravity());
 
+// Avance la simulation à un instant donné.
+// Les mobiles ne sont avancés que lorsqu'ils participent à un événement, ou avant un dessin ou une mesure.
+void Simulateur::avance(const Time& time)
+{
     mState.now = time;
 }
 
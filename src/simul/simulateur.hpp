@@ -21,7 +21,9 @@
 
 #include <QLabel>
 #include <QSlider>
+#include <QComboBox>
 #include "courbes_group.hpp"
+#include "instantane.hpp"
 #include "state.hpp"
 
 // Widget pour simuler une configuration.
@@ -35,20 +37,28 @@ public:
 
     // Redémarre la simulation.
     void doRestart();
-    // Avance jusqu'au prochain événement de dessin.
-    void playToNextDraw();
+    // Avance jusqu'au prochain événement de dessin, sans dépasser le temps de calcul accordé (en millisecondes).
+    // Renvoie vrai si le dessin a été atteint (peut être appelé depuis un thread de calcul).
+    bool playSlice(int msec);
+    // Transmet à l'interface graphique les mises à jour en attente (courbes, statut).
+    void refreshView();
+    // Redessine le dernier instantané publié s'il est nouveau (peut être appelé pendant le calcul).
+    void refreshDrawing();
     // Avance jusqu'au prochain événement et effectue tous les événements de cette date.
     bool playNext();
 
-    // Dessine l'état actuel de la simulation.
+    // Dessine le dernier instantané publié de la simulation.
     void draw(QPainter& painter, double width);
+    // Etat de la simulation (pour les mesures faites hors de l'interface graphique).
+    inline State& state();
 
     // Effectue un événement.
-    bool performCollision(Collision& collision);
+    bool performCollision(const Collision& collision);
+    bool performMobileEvent(unsigned int index);
     bool performDrawEvent();
     bool performValueEvent();
     bool performCourbeEvent();
-    bool performBouleEvent(Boule* boule);
+    bool performBouleEvent(unsigned int index);
     // Ajoute un événement.
     void addDrawEvent();
     void addValueEvent();
@@ -67,15 +77,21 @@ private slots:
     //void setArea(int value);
     void setValues(int value);
     void setCourbes(int value);
+    // Change la structure ordonnant les événements.
+    void setScheduler(int index);
+    // Change la recherche des collisions entre boules.
+    void setRecherche(int index);
 
 private:
     // Génère un texte pour la barre de statut (images par seconde, etc).
-    void emitStatusText(unsigned int msec, unsigned int frames, unsigned int chocs, unsigned int chocsTotal);
+    void makeStatusText(unsigned int msec, unsigned int frames, unsigned int chocs, unsigned int chocsTotal);
 
     // Met à jour les collisions en partant des mobiles concernés par la(les) dernière(s) effectuée(s).
     void refreshCollisions();
     // Met à jour les événements de dessin (supprime ceux qui viennent d'être effectués).
     void refreshDrawings();
+    // Publie un instantané de l'état présent pour le dessin.
+    void publishDrawing();
 
     // Avance la simulation à un instant donné.
     void avance(const Time& time);
@@ -94,8 +110,22 @@ private:
     QSlider* mSliderValues;
     QLabel* mLabelCourbes;
     QSlider* mSliderCourbes;
+    QLabel* mLabelScheduler;
+    QComboBox* mComboScheduler;
+    QLabel* mLabelRecherche;
+    QComboBox* mComboRecherche;
+
+    // Mises à jour de l'interface graphique en attente.
+    QList<CourbesGroup::Mesure> mMesuresPending;
+    bool mCourbesPending;
+    QString mStatusText;
 
     State mState;
+    Instantanes mInstantanes;
 };
 
+// Etat de la simulation.
+inline State& Simulateur::state()
+    {return mState;}
+
 #endif // SIMULATEUR_HPP
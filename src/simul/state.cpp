@@ -18,14 +18,35 @@
 
 #include "state.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <limits>
+#include <tuple>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+constexpr unsigned int State::boulesParTache;
+constexpr double State::boulesParCase;
+constexpr double State::facteurVoisins;
+constexpr double State::dureeOrigine;
+
 // Constructeur.
 State::State(const Configuration& cfg) :
     config(cfg),
     sizeArea(),
+    gravite(Gravite::_nulle),
+    recherche(_cases),
     countChocs(0),
-    countEtudes(0, 0),
+    countZones(0),
+    countEtudes(),
+    countDegeneres(),
     totalEtudes(0)
 {
+    // Graine propre à chaque simulation (les états sont construits sur le thread de l'interface graphique).
+    static unsigned int simulations = 0;
+    std::seed_seq graine{static_cast<unsigned int>(std::time(0)), ++simulations};
+    generateur.seed(graine);
 }
 
 
@@ -34,15 +55,23 @@ void State::clear()
 {
     events.clear();
     toRefresh.clear();
+    toSchedule.clear();
     drawingsRefresh.clear();
+    lot.clear();
     populations.clear();
     boules.clear();
     pistons.clear();
-    mapMobiles.clear();
+    mobiles.clear();
+    sommets.clear();
+    segments.clear();
+    grilles.clear();
+    particules.clear();
     now = 0;
+    origine = 0;
     countChocs = 0;
-    countEtudes.first = 0;
-    countEtudes.second = 0;
+    countZones = 0;
+    countEtudes = Etudes();
+    countDegeneres = Degeneres();
     totalEtudes = 0;
     frames.clear();
 }
@@ -51,6 +80,11 @@ void State::clear()
 void State::create()
 {
     sizeArea = config.sizeArea();
+    gravite = Gravite::type(config.gravity());
+    this->createGrilles();
+
+    // Les premiers événements ne sont ordonnés qu'une fois tous connus (construction du tas en bloc).
+    events.suspend();
 
     // Création des obstacles.
     this->addObstacles();
@@ -69,6 +103,213 @@ void State::create()
         populations.push_back(Population(configPops[i]));
         populations.back().create(i, *this);
     }
+    this->premieresCollisions();
+
+    this->schedule();
+    events.resume();
+}
+
+// Amène tous les mobiles à l'instant présent.
+void State::synchronize()
+{
+    for (auto& boule : boules)
+        boule->synchronize(*this);
+    for (auto& piston : pistons)
+        piston->synchronize(*this);
+}
+
+// Ramène l'origine des temps à l'instant présent lorsque la simulation s'en est trop éloignée.
+// Les mobiles sont amenés à l'instant présent, puis toutes les dates prévues sont décalées de la même quantité
+// (ce qui préserve leur ordre).
+void State::recale()
+{
+    if (now.time() < dureeOrigine)
+        return;
+
+    for (auto& mobile : mobiles)
+        mobile->recale(*this);
+    events.recale(now);
+
+    origine += now;
+    now = 0;
+}
+
+// Calcule l'état présent des boules dans les tableaux des particules, et amène les pistons à l'instant présent.
+void State::updateView()
+{
+    particules.avance(now, config.gravity());
+    for (auto& piston : pistons)
+        piston->synchronize(*this);
+}
+
+// Met à jour les entrées des mobiles dont les prochaines collisions ont changé.
+void State::schedule()
+{
+    for (auto& mobile : toSchedule)
+        mobile->schedule(*this);
+    toSchedule.clear();
+}
+
+// Change la recherche des collisions (les grilles sont reconstruites et tous les mobiles à mettre à jour).
+void State::setRecherche(Recherche value)
+{
+    if (value == recherche)
+        return;
+    recherche = value;
+    if (grilles.empty())
+        return;
+
+    // Les grilles sont reconstruites avec la taille de cases correspondante, et les objets y sont replacés.
+    this->synchronize();
+    this->createGrilles();
+    for (unsigned int i = 0 ; i < sommets.size() ; ++i)
+        this->attachSommet(i);
+    for (unsigned int i = 0 ; i < segments.size() ; ++i)
+        this->attachSegment(i);
+    for (auto& piston : pistons)
+        piston->resetArea(*this);
+    for (auto& boule : boules)
+        boule->resetArea(*this);
+    if (recherche == _voisins)
+        for (auto& boule : boules)
+            boule->updateVoisins(*this);
+    for (auto& mobile : mobiles)
+        toRefresh.insert(mobile);
+}
+
+
+// Cherche les premières collisions des boules, une fois toutes placées.
+// Le résultat est celui d'une recherche faite par chaque boule juste après avoir été placée : les collisions entre
+// boules, qui dominent le coût, sont d'abord calculées en parallèle, chaque boule n'étudiant que celles placées
+// avant elle sans rien modifier d'autre que son résultat. Les collisions sont ensuite ajoutées dans l'ordre
+// de création, avec celles des pistons et des obstacles.
+void State::premieresCollisions()
+{
+    // Boules rangées par case : une tâche traite des cases entières, dont les boules étudient les mêmes voisines.
+    std::vector<Boule*> ordre;
+    ordre.reserve(boules.size());
+    for (auto& boule : boules)
+        ordre.push_back(boule.get());
+
+    auto cle = [this](const Boule* boule)
+        {return std::make_tuple(this->niveau(boule->rayon()), boule->area().y, boule->area().x);};
+    std::stable_sort(ordre.begin(), ordre.end(), [&](const Boule* b1, const Boule* b2) {return cle(b1) < cle(b2);});
+
+    // Découpage en tâches de cases entières, quelques-unes par thread pour équilibrer la charge.
+    unsigned int threads = std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+    unsigned int nombre = std::max(1u, std::min<unsigned int>(ordre.size() / boulesParTache, 4 * threads));
+    std::vector<std::pair<unsigned int, unsigned int> > taches;
+    unsigned int debut = 0;
+    for (unsigned int i = 1 ; i <= nombre && debut < ordre.size() ; ++i)
+    {
+        unsigned int fin = (unsigned long long)ordre.size() * i / nombre;
+        while (fin > debut && fin < ordre.size() && cle(ordre[fin]) == cle(ordre[fin - 1]))
+            ++fin;
+        if (fin > debut)
+            taches.push_back(std::make_pair(debut, fin));
+        debut = fin;
+    }
+
+    // Collisions entre boules.
+    std::vector<Boule::Premieres> premieres(boules.size());
+    auto cherche = [&](std::pair<unsigned int, unsigned int>& tache) {
+        std::vector<Boule*> lot;
+        Quadratiques equations;
+        for (unsigned int i = tache.first ; i < tache.second ; ++i)
+            ordre[i]->chercheLot(*this, lot, equations, premieres[ordre[i]->rang()]);
+    };
+    if (taches.size() > 1)
+        QtConcurrent::blockingMap(taches, cherche);
+    else
+        for (auto& tache : taches)
+            cherche(tache);
+
+    // Ajout des collisions dans l'ordre de création.
+    for (auto& boule : boules)
+        boule->premieresCollisions(premieres[boule->rang()], *this);
+}
+
+// Crée une grille par classe de rayons, sur le rectangle englobant le domaine.
+void State::createGrilles()
+{
+    // Rectangle englobant les polygones délimitant le domaine.
+    std::vector<const Polygone*> polygones;
+    polygones.push_back(&config.contour().sommets());
+    for (auto& obstacle : config.obstacles())
+        polygones.push_back(&obstacle.sommets());
+    const auto& configPops = config.configPops();
+    for (auto& population : configPops)
+        polygones.push_back(&population.mPolygone);
+
+    double infini = std::numeric_limits<double>::infinity();
+    Coord<double> min(infini, infini);
+    Coord<double> max(-infini, -infini);
+    unsigned int sommets = 0;
+    for (auto& polygone : polygones)
+    {
+        sommets += polygone->size();
+        for (unsigned int j = 0 ; j < polygone->size() ; ++j)
+        {
+            min = min.min(polygone->point(j));
+            max = max.max(polygone->point(j));
+        }
+    }
+
+    // Populations par ordre décroissant de rayon.
+    std::vector<const ConfigPopulation*> populations;
+    for (auto& population : configPops)
+        if (population.mTaille)
+            populations.push_back(&population);
+    std::sort(populations.begin(), populations.end(), [](const ConfigPopulation* a, const ConfigPopulation* b) {
+        return a->mRayon > b->mRayon;
+    });
+
+    // Classes de rayons : la taille des cases est adaptée aux plus grosses boules de la classe, sans que les cases
+    // contiennent en moyenne moins de "boulesParCase" boules (sinon les changements de case coûtent plus qu'ils
+    // ne font gagner). Une nouvelle classe n'est créée que si ses cases sont au moins deux fois plus petites.
+    std::vector<double> rayons;
+    std::vector<double> tailles;
+    for (auto& population : populations)
+    {
+        double densite = population->mTaille / std::fabs(population->mPolygone.surface());
+        double taille = rayons.empty() ? sizeArea : std::max(sizeArea * population->mRayon / rayons.front(), std::sqrt(boulesParCase / densite));
+        if (rayons.empty() || taille <= tailles.back() / 2)
+        {
+            rayons.push_back(population->mRayon);
+            tailles.push_back(taille);
+        }
+    }
+    if (rayons.empty())
+    {
+        rayons.push_back(0);
+        tailles.push_back(sizeArea);
+    }
+
+    // Nombre d'objets par classe (pour le choix de la structure des grilles).
+    std::vector<unsigned int> counts(rayons.size(), sommets);
+    for (auto& population : populations)
+    {
+        unsigned int i = 0;
+        while (i + 1 < rayons.size() && rayons[i + 1] >= population->mRayon)
+            ++i;
+        counts[i] += population->mTaille;
+    }
+
+    // La première grille (la plus grossière) contient aussi les pistons.
+    // Avec les listes de voisins, les cases sont agrandies pour laisser une peau plus épaisse.
+    double facteur = recherche == _voisins ? facteurVoisins : 1;
+    grilles.resize(rayons.size());
+    for (unsigned int i = 0 ; i < rayons.size() ; ++i)
+        grilles[i].resize(facteur * tailles[i], rayons[i], min, max, counts[i]);
+}
+
+// Indice de la grille correspondant au rayon (la plus fine dont les boules sont au moins aussi grosses).
+unsigned int State::niveau(double rayon) const
+{
+    unsigned int niveau = 0;
+    while (niveau + 1 < grilles.size() && grilles[niveau + 1].rayon() >= rayon)
+        ++niveau;
+    return niveau;
 }
 
 
@@ -86,35 +327,89 @@ void State::addObstacle(const Polygone& sommets)
 {
     for (unsigned int j = 0 ; j < sommets.size() ; ++j)
     {
-        const Coord<double>& point = sommets.point(j);
-        mapMobiles[std::floor(point.y / sizeArea)].sommets().insert(std::floor(point.x / sizeArea), point);
+        this->addSommet(sommets.point(j));
         this->addSegment(sommets.segment(j));
     }
 }
 
+// Ajoute un sommet à la simulation.
+void State::addSommet(const Coord<double>& sommet)
+{
+    sommets.push_back(sommet);
+    this->attachSommet(sommets.size() - 1);
+}
+
 // Ajoute un segment à la simulation.
 void State::addSegment(const Segment& segment)
 {
-    // Extrémités du segment.
-    Coord<int> point1 = segment.point1(sizeArea);
-    Coord<int> point2 = segment.point2(sizeArea);
+    segments.push_back(segment);
+    this->attachSegment(segments.size() - 1);
+}
 
-    // Rectangle contenant le segment.
-    Coord<int> min = point1.min(point2);
-    Coord<int> max = point1.max(point2);
+// Répertorie un sommet dans sa case et les cases voisines (dans chaque grille).
+void State::attachSommet(unsigned int index)
+{
+    for (auto& grille : grilles)
+    {
+        Coord<int> area = grille.area(sommets[index]);
+        for (int j = area.y - 1 ; j <= area.y + 1 ; ++j)
+            for (int i = area.x - 1 ; i <= area.x + 1 ; ++i)
+                grille.cell(Coord<int>(i, j)).mSommets.push_back(index);
+    }
+}
 
-    // Ajout aux zones intersectées.
-    for (int i = min.x ; i < max.x ; ++i)
+// Répertorie un segment dans les cases qu'il traverse et leurs voisines (dans chaque grille).
+void State::attachSegment(unsigned int index)
+{
+    const Segment& segment = segments[index];
+    for (auto& grille : grilles)
     {
-        int y = std::floor(segment.yAtX(i * sizeArea) / sizeArea);
-        mapMobiles[y].segments()[i].insert(segment);
-        mapMobiles[y].segments()[i + 1].insert(segment);
+        // Extrémités du segment, en unités de cases.
+        Coord<double> debut = segment.debut() / grille.sizeArea();
+        Coord<double> fin = segment.fin() / grille.sizeArea();
+        Coord<double> delta = fin - debut;
+
+        Coord<int> area(std::floor(debut.x), std::floor(debut.y));
+        Coord<int> last(std::floor(fin.x), std::floor(fin.y));
+        Coord<int> step(delta.x >= 0 ? 1 : -1, delta.y >= 0 ? 1 : -1);
+
+        // Position (de 0 à 1 le long du segment) des prochains changements de colonne et de ligne, et leurs incréments (DDA).
+        double infini = std::numeric_limits<double>::infinity();
+        Coord<double> next(delta.x != 0 ? ((step.x > 0 ? area.x + 1 : area.x) - debut.x) / delta.x : infini,
+                           delta.y != 0 ? ((step.y > 0 ? area.y + 1 : area.y) - debut.y) / delta.y : infini);
+        Coord<double> increment(delta.x != 0 ? step.x / delta.x : infini,
+                                delta.y != 0 ? step.y / delta.y : infini);
+
+        // Parcours des cases traversées : les erreurs d'arrondi (passage par un coin) sont couvertes par l'ajout aux cases voisines.
+        this->attachSegment(grille, area, index);
+        while (area != last)
+        {
+            if (area.y == last.y || (area.x != last.x && next.x < next.y))
+            {
+                area.x += step.x;
+                next.x += increment.x;
+            }
+            else
+            {
+                area.y += step.y;
+                next.y += increment.y;
+            }
+            this->attachSegment(grille, area, index);
+        }
     }
+}
 
-    for (int j = min.y ; j < max.y ; ++j)
+// Répertorie un segment dans une case traversée et ses voisines.
+void State::attachSegment(Grille& grille, const Coord<int>& area, unsigned int index)
+{
+    // Les segments sont ajoutés un par un : un doublon ne peut être que le dernier élément.
+    for (int j = area.y - 1 ; j <= area.y + 1 ; ++j)
     {
-        int x = std::floor(segment.xAtY(j * sizeArea) / sizeArea);
-        mapMobiles[j].segments()[x].insert(segment);
-        mapMobiles[j + 1].segments()[x].insert(segment);
+        for (int i = area.x - 1 ; i <= area.x + 1 ; ++i)
+        {
+            std::vector<unsigned int>& segments = grille.cell(Coord<int>(i, j)).mSegments;
+            if (segments.empty() || segments.back() != index)
+                segments.push_back(index);
+        }
     }
 }
@@ -20,17 +20,44 @@
 #define STATE_HPP
 
 #include <QTime>
+#include <random>
 #include "population.hpp"
 #include "boule.hpp"
 #include "piston.hpp"
 #include "collision.hpp"
 #include "obstacle.hpp"
-#include "map_ligne.hpp"
+#include "grille.hpp"
+#include "particules.hpp"
+#include "quadratiques.hpp"
 
 // Classe représentant l'état de la simulation.
 class State
 {
 public:
+    // Recherche des collisions entre boules : dans les cases voisines (un événement à chaque changement de case),
+    // ou dans des listes de voisins (un événement quand la boule sort de sa peau).
+    enum Recherche
+    {
+        _cases = 0, _voisins = 1
+    };
+
+    // Nombre de collisions étudiées : au total, entre mobiles, et écartées sans résolution d'équation
+    // (rectangles balayés disjoints avant l'horizon, ou avant le changement de zone pour les obstacles).
+    struct Etudes
+    {
+        unsigned int total;
+        unsigned int mobiles;
+        unsigned int ecartees;
+    };
+
+    // Cas dégénérés rencontrés : collisions effectuées alors que les objets ne se rapprochent pas (contacts rasants,
+    // ignorés), et collisions prévues une seconde fois au même instant (écartées).
+    struct Degeneres
+    {
+        unsigned int rasantes;
+        unsigned int repetees;
+    };
+
     // Constructeur.
     State(const Configuration& cfg);
 
@@ -38,12 +65,47 @@ public:
     void clear();
     // Construit une nouvelle simulation à partir de la configuration.
     void create();
+    // Amène tous les mobiles à l'instant présent.
+    void synchronize();
+    // Ramène l'origine des temps à l'instant présent lorsque la simulation s'en est trop éloignée
+    // (les dates relatives à une origine lointaine perdent leurs derniers chiffres significatifs).
+    void recale();
+    // Calcule l'état présent des boules dans les tableaux des particules, et amène les pistons à l'instant présent
+    // (avant un dessin ou une mesure).
+    void updateView();
+    // Indice de la grille correspondant au rayon.
+    unsigned int niveau(double rayon) const;
+    // Met à jour les entrées des mobiles dont les prochaines collisions ont changé.
+    void schedule();
+    // Change la recherche des collisions (les grilles sont reconstruites et tous les mobiles à mettre à jour).
+    void setRecherche(Recherche recherche);
+
+    // Instant présent depuis le début de la simulation (pour les mesures).
+    inline Time instant() const;
 
 private:
+    // Nombre minimal de boules par tâche pour la recherche initiale en parallèle.
+    static constexpr unsigned int boulesParTache = 4096;
+    // Nombre moyen de boules par case en deçà duquel une classe de rayons n'a pas sa propre grille.
+    static constexpr double boulesParCase = 1;
+    // Agrandissement des cases avec les listes de voisins.
+    static constexpr double facteurVoisins = 2;
+    // Durée simulée au-delà de laquelle l'origine des temps est déplacée.
+    static constexpr double dureeOrigine = 64;
+
+    // Crée une grille par classe de rayons, sur le rectangle englobant le domaine.
+    void createGrilles();
+    // Cherche les premières collisions des boules, une fois toutes placées.
+    void premieresCollisions();
     // Ajoute des éléments à la simulation.
     void addObstacles();
     void addObstacle(const Polygone& sommets);
+    void addSommet(const Coord<double>& sommet);
     void addSegment(const Segment& segment);
+    // Répertorie les obstacles dans les cases des grilles.
+    void attachSommet(unsigned int index);
+    void attachSegment(unsigned int index);
+    void attachSegment(Grille& grille, const Coord<int>& area, unsigned int index);
 
 public:
     // Configuration et objets de la simulation.
@@ -51,14 +113,29 @@ public:
     std::vector<Population> populations;
     std::vector<std::unique_ptr<Boule> > boules;
     std::vector<std::unique_ptr<Piston> > pistons;
-    std::map<int, MapLigne> mapMobiles;
+    std::vector<Mobile*> mobiles;
+    std::vector<Coord<double> > sommets;
+    std::vector<Segment> segments;
+    std::vector<Grille> grilles;
+    // Copie des trajectoires des boules pour le dessin et les mesures.
+    Particules particules;
+    // Générateur de nombres aléatoires (propre à la simulation, qui peut avancer sur n'importe quel thread de calcul).
+    std::mt19937 generateur;
+    // Instant présent, compté depuis l'origine des temps, et date de cette origine depuis le début de la simulation.
     Time now;
+    Time origine;
     double sizeArea;
+    Gravite::Type gravite;
+    Recherche recherche;
 
     // Evénements à simuler.
-    std::multimap<Time, std::shared_ptr<Event> > events;
+    EventQueue events;
     std::set<Mobile*> toRefresh;
-    std::list<std::multimap<Time, std::shared_ptr<Event> >::iterator> drawingsRefresh;
+    std::vector<Mobile*> toSchedule;
+    std::vector<EventQueue::Handle> drawingsRefresh;
+    // Boules dont les collisions sont calculées ensemble, et équations correspondantes.
+    std::vector<Boule*> lot;
+    Quadratiques quadratiques;
 
     // Fréquences d'affichage.
     Time stepDraw;
@@ -66,9 +143,15 @@ public:
     Time stepCourbes;
     // Statistiques.
     unsigned int countChocs;
-    std::pair<unsigned int, unsigned int> countEtudes;
+    unsigned int countZones;
+    Etudes countEtudes;
+    Degeneres countDegeneres;
     unsigned int totalEtudes;
     std::list<std::pair<QTime, unsigned int> > frames;
 };
 
+// Instant présent depuis le début de la simulation.
+inline Time State::instant() const
+    {return origine + now;}
+
 #endif // STATE_HPP
@@ -18,92 +18,15 @@
 
 #include "time.hpp"
 
+// Valeur représentant "jamais".
+constexpr double Time::never;
+
 // Affichage dans un flux standard.
 std::ostream& operator<<(std::ostream& flux, const Time& time)
 {
-    if (time.mNever)
+    if (time.isNever())
         flux << "never";
     else
         flux << time.mTime;
     return flux;
 }
-
-
-// Constructeurs.
-Time::Time() :
-    mTime(0),
-    mNever(true)
-{
-}
-
-Time::Time(double time) :
-    mTime(time >= 0 ? time : 0),
-    mNever(time >= 0 ? false : true)
-{
-}
-
-Time::Time(const Time& time) :
-    mTime(time.mTime),
-    mNever(time.mNever)
-{
-}
-
-
-// Opérateurs.
-void Time::operator=(const Time& time)
-{
-    mTime = time.mTime;
-    mNever = time.mNever;
-}
-
-Time Time::operator-(const Time& time) const
-{
-    Time result(*this);
-    result -= time;
-    return result;
-}
-
-void Time::operator-=(const Time& time)
-{
-    if (mNever || time.mNever || mTime < time.mTime)
-    {
-        mNever = true;
-        mTime = 0;
-    }
-    else
-        mTime -= time.mTime;
-}
-
-Time Time::operator+(const Time& time) const
-{
-    Time result(*this);
-    result += time;
-    return result;
-}
-
-void Time::operator+=(const Time& time)
-{
-    if (mNever || time.mNever)
-    {
-        mNever = true;
-        mTime = 0;
-    }
-    else
-        mTime += time.mTime;
-}
-
-
-// Comparaison.
-bool Time::operator<(const Time& time) const
-{
-    return mNever ? false : (time.mNever ? true : mTime < time.mTime);
-}
-
-bool Time::operator==(const Time& time) const
-{
-    return (mNever == time.mNever
-            ? (mNever
-               ? true
-               : mTime == time.mTime)
-            : false);
-}
@@ -20,8 +20,10 @@
 #define TIME_HPP
 
 #include <iostream>
+#include <limits>
 
 // Classe pour gérer un moment dans le temps.
+// "Jamais" est représenté par l'infini, ce qui rend les comparaisons et les opérations sans branchement.
 class Time
 {
 public:
@@ -29,21 +31,19 @@ public:
     friend std::ostream& operator<<(std::ostream& flux, const Time& time);
 
     // Constructeurs.
-    Time(); // Jamais.
-    Time(double time);
-    Time(const Time& time);
+    inline Time(); // Jamais.
+    inline Time(double time);
 
     // Opérateurs.
-    void operator=(const Time& time);
-    void operator-=(const Time& time);
-    Time operator-(const Time& time) const;
-    void operator+=(const Time& time);
-    Time operator+(const Time& time) const;
+    inline void operator-=(const Time& time);
+    inline Time operator-(const Time& time) const;
+    inline void operator+=(const Time& time);
+    inline Time operator+(const Time& time) const;
 
     // Comparaison.
-    bool operator<(const Time& time) const;
+    inline bool operator<(const Time& time) const;
     inline bool operator<=(const Time& time) const;
-    bool operator==(const Time& time) const;
+    inline bool operator==(const Time& time) const;
     inline bool operator!=(const Time& time) const;
 
     // Accesseurs.
@@ -51,23 +51,43 @@ public:
     inline double time() const;
 
 private:
+    // Valeur représentant "jamais".
+    static constexpr double never = std::numeric_limits<double>::infinity();
+
     // Temps virtuel (dans le référentiel de la simulation) depuis le début de la simulation.
     double mTime;
-    // Jamais.
-    bool mNever;
 };
 
+// Constructeurs.
+inline Time::Time() :
+    mTime(never) {}
+inline Time::Time(double time) :
+    mTime(time >= 0 ? time : never) {}
+
+// Opérateurs (une différence négative ou indéterminée donne "jamais").
+inline void Time::operator-=(const Time& time)
+    {double result = mTime - time.mTime; mTime = (result >= 0 ? result : never);}
+inline Time Time::operator-(const Time& time) const
+    {return Time(mTime - time.mTime);}
+inline void Time::operator+=(const Time& time)
+    {mTime += time.mTime;}
+inline Time Time::operator+(const Time& time) const
+    {Time result(*this); result += time; return result;}
+
 // Comparaison.
-//*
-bool Time::operator<=(const Time& time) const
-    {return !(time < *this);}//*/
-bool Time::operator!=(const Time& time) const
-    {return !(time == *this);}
+inline bool Time::operator<(const Time& time) const
+    {return mTime < time.mTime;}
+inline bool Time::operator<=(const Time& time) const
+    {return mTime <= time.mTime;}
+inline bool Time::operator==(const Time& time) const
+    {return mTime == time.mTime;}
+inline bool Time::operator!=(const Time& time) const
+    {return mTime != time.mTime;}
 
 // Accesseurs.
-bool Time::isNever() const
-    {return mNever;}
-double Time::time() const
+inline bool Time::isNever() const
+    {return mTime == never;}
+inline double Time::time() const
     {return mTime;}
 
 #endif // TIME_HPP
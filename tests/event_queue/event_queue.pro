@@ -0,0 +1,45 @@
+#   Collisions - a real-time simulation program of colliding particles.
+#   Copyright (C) 2011 - 2015  G. Endignoux
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+
+
+
+# Ordre des événements d'une file remplie pendant une suspension (make check).
+TEMPLATE = app
+TARGET = event_queue_test
+CONFIG += console testcase
+CONFIG -= app_bundle
+QT =
+SRC = ../../src
+INCLUDEPATH += $$SRC/simul
+
+HEADERS += \
+    $$SRC/simul/calendar_scheduler.hpp \
+    $$SRC/simul/event.hpp \
+    $$SRC/simul/event_queue.hpp \
+    $$SRC/simul/heap_scheduler.hpp \
+    $$SRC/simul/scheduler.hpp \
+    $$SRC/simul/time.hpp
+
+SOURCES += \
+    $$SRC/simul/calendar_scheduler.cpp \
+    $$SRC/simul/event_queue.cpp \
+    $$SRC/simul/heap_scheduler.cpp \
+    $$SRC/simul/scheduler.cpp \
+    $$SRC/simul/time.cpp \
+    event_queue_test.cpp
+
+CONFIG += c++14
+QMAKE_CXXFLAGS += --std=c++14
@@ -0,0 +1,112 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include <iostream>
+#include <random>
+#include "event_queue.hpp"
+
+// Vérifie qu'une file remplie pendant une suspension (événements ajoutés, modifiés, retirés et supprimés avant
+// la reprise) rend les événements dans le même ordre qu'une file ayant subi les mêmes opérations sans suspension.
+static bool compare(Scheduler::Type type, unsigned int graine)
+{
+    EventQueue eager(type);
+    EventQueue suspended(type);
+    std::mt19937 generateur(graine);
+    std::uniform_real_distribution<> distribTime(0, 100);
+    std::uniform_int_distribution<> distribOperation(0, 9);
+
+    // Opérations identiques sur les deux files (les identifiants attribués sont donc les mêmes).
+    std::vector<EventQueue::Handle> handles;
+    auto operation = [&]() {
+        int choix = distribOperation(generateur);
+        if (handles.empty() || choix < 4)
+        {
+            Time time = distribTime(generateur);
+            handles.push_back(eager.insert(time, Event(Event::_mobile, handles.size())));
+            suspended.insert(time, Event(Event::_mobile, handles.size()));
+            return;
+        }
+
+        std::uniform_int_distribution<> distribHandle(0, handles.size() - 1);
+        unsigned int i = distribHandle(generateur);
+        EventQueue::Handle handle = handles[i];
+        if (choix < 7)
+        {
+            Time time = distribTime(generateur);
+            eager.update(handle, time);
+            suspended.update(handle, time);
+        }
+        else if (choix < 9)
+        {
+            eager.remove(handle);
+            suspended.remove(handle);
+        }
+        else
+        {
+            eager.erase(handle);
+            suspended.erase(handle);
+            handles[i] = handles.back();
+            handles.pop_back();
+        }
+    };
+
+    // Quelques événements sont ordonnés avant la suspension.
+    for (unsigned int i = 0 ; i < 50 ; ++i)
+        operation();
+    suspended.suspend();
+    for (unsigned int i = 0 ; i < 2000 ; ++i)
+        operation();
+    suspended.resume();
+
+    if (eager.size() != suspended.size())
+    {
+        std::cerr << "scheduler " << type << ", seed " << graine << ": " << suspended.size()
+                  << " events instead of " << eager.size() << std::endl;
+        return false;
+    }
+
+    for (unsigned int rang = 0 ; !eager.empty() ; ++rang)
+    {
+        EventQueue::Handle attendu = eager.top();
+        EventQueue::Handle obtenu = suspended.top();
+        if (attendu != obtenu || eager.time(attendu) != suspended.time(obtenu))
+        {
+            std::cerr << "scheduler " << type << ", seed " << graine << ": event " << obtenu << " at "
+                      << suspended.time(obtenu) << " popped at rank " << rang << " instead of " << attendu
+                      << " at " << eager.time(attendu) << std::endl;
+            return false;
+        }
+        eager.pop();
+        suspended.pop();
+    }
+
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    for (unsigned int graine = 0 ; graine < 20 ; ++graine)
+    {
+        ok = compare(Scheduler::_heap, graine) && ok;
+        ok = compare(Scheduler::_calendar, graine) && ok;
+    }
+
+    std::cout << (ok ? "event_queue: ok" : "event_queue: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+#   Collisions - a real-time simulation program of colliding particles.
+#   Copyright (C) 2011 - 2015  G. Endignoux
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+
+
+
+# Racines des équations résolues par lot, comparées à la résolution une à une (make check).
+TEMPLATE = app
+TARGET = quadratiques_test
+CONFIG += console testcase
+CONFIG -= app_bundle
+QT =
+SRC = ../../src
+INCLUDEPATH += $$SRC/math
+
+HEADERS += \
+    $$SRC/math/quadratiques.hpp \
+    $$SRC/math/solveur.hpp
+
+SOURCES += \
+    $$SRC/math/quadratiques.cpp \
+    $$SRC/math/solveur.cpp \
+    quadratiques_test.cpp
+
+CONFIG += c++14
+QMAKE_CXXFLAGS += --std=c++14
@@ -0,0 +1,87 @@
+/*
+    Collisions - a real-time simulation program of colliding particles.
+    Copyright (C) 2011 - 2015  G. Endignoux
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/gpl-3.0.txt
+*/
+
+#include <cstring>
+#include <iostream>
+#include <random>
+#include "quadratiques.hpp"
+#include "solveur.hpp"
+
+// Compare les racines calculées par lot (instructions vectorielles, puis une à une pour les dernières)
+// à celles de Solveur::fstApproche, au bit près.
+static bool compare(const std::vector<double>& a, const std::vector<double>& b, const std::vector<double>& c)
+{
+    Quadratiques equations;
+    for (unsigned int i = 0 ; i < a.size() ; ++i)
+        equations.add(a[i], b[i], c[i]);
+    equations.fstApproches();
+
+    for (unsigned int i = 0 ; i < a.size() ; ++i)
+    {
+        double attendu = Solveur::fstApproche(a[i], b[i], c[i]);
+        double obtenu = equations.racine(i);
+        if (std::memcmp(&attendu, &obtenu, sizeof(double)))
+        {
+            std::cerr.precision(17);
+            std::cerr << "equation " << i << "/" << a.size() << " (" << a[i] << ", " << b[i] << ", " << c[i]
+                      << "): " << obtenu << " instead of " << attendu << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+
+    // Cas particuliers : contact rasant (b nul), éloignement, chevauchement en approche ou non,
+    // vitesses égales (a nul), discriminant négatif ou nul.
+    std::vector<double> a = {1, 1, 1, 1, 1, 0, 0, 0, 1, 1, 2, 1e-300, 1e300};
+    std::vector<double> b = {0, 3, -3, -3, 3, -2, 2, 0, -1, -2, -4, -1e-150, -1e150};
+    std::vector<double> c = {1, 1, 1, -1, -1, 1, 1, -1, 1, 1, 2, 1e-300, 1e300};
+    ok = compare(a, b, c) && ok;
+
+    // Lots de toutes tailles (parties vectorielles et restes), issus de paires de boules aléatoires.
+    std::mt19937 generateur(0);
+    std::uniform_real_distribution<> distribPosition(-10, 10);
+    std::normal_distribution<> distribVitesse(0, 1);
+    std::uniform_real_distribution<> distribRayon(0.01, 2);
+    for (unsigned int n = 0 ; n < 200 ; ++n)
+    {
+        a.clear();
+        b.clear();
+        c.clear();
+        for (unsigned int i = 0 ; i < n ; ++i)
+        {
+            // Coefficients calculés comme dans Boule::equation.
+            double dx = distribPosition(generateur);
+            double dy = distribPosition(generateur);
+            double dvx = distribVitesse(generateur);
+            double dvy = distribVitesse(generateur);
+            double rayons = distribRayon(generateur);
+            a.push_back(dvx * dvx + dvy * dvy);
+            b.push_back(2.0 * (dvx * dx + dvy * dy));
+            c.push_back(dx * dx + dy * dy - rayons * rayons);
+        }
+        ok = compare(a, b, c) && ok;
+    }
+
+    std::cout << (ok ? "quadratiques: ok" : "quadratiques: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}